@@ -0,0 +1,105 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "../headers/DataReader.h"
+
+/*
+ * Load-time benchmark of the CSV readers: readLocations/readDistances (getline and istringstream) against
+ * loadLocations/loadDistances (memory-mapped, parsed in place), checking that both build the same graph, then
+ * loadDistancesParallel with 1, 2, 4, ... threads, checking that it builds the same network as CsrGraph(graph).
+ * Also reports the memory used by the graph.
+ * Usage: `load_bench [locations.csv] [distances.csv] [max threads]` (defaults: the files in ../docs, one per hardware thread).
+ */
+
+using namespace std;
+
+static bool sameGraph(const Graph<int> &a, const Graph<int> &b) {
+    auto va = a.getVertexSet(), vb = b.getVertexSet();
+    if (va.size() != vb.size()) return false;
+    for (size_t i = 0; i < va.size(); i++) {
+        if (va[i]->getID() != vb[i]->getID() || va[i]->getCode() != vb[i]->getCode()
+            || va[i]->getName() != vb[i]->getName() || va[i]->getParking() != vb[i]->getParking()) return false;
+        auto ea = va[i]->getAdj(), eb = vb[i]->getAdj();
+        if (ea.size() != eb.size()) return false;
+        for (size_t j = 0; j < ea.size(); j++) {
+            if (ea[j]->getDest()->getID() != eb[j]->getDest()->getID() || ea[j]->getWeight() != eb[j]->getWeight()
+                || ea[j]->getMode() != eb[j]->getMode()) return false;
+        }
+    }
+    return true;
+}
+
+static bool sameNetwork(const CsrGraph &a, const CsrGraph &b) {
+    if (a.getNumVertex() != b.getNumVertex()) return false;
+    for (int m = 0; m < CsrGraph::NUM_MODES; m++) {
+        if (a.getNumEdges(m) != b.getNumEdges(m)) return false;
+        for (int v = 0; v < a.getNumVertex(); v++) {
+            if (a.getID(v) != b.getID(v) || a.edgeEnd(m, v) != b.edgeEnd(m, v)) return false;
+        }
+        for (unsigned e = 0; e < a.getNumEdges(m); e++) {
+            if (a.getTarget(m, e) != b.getTarget(m, e) || a.getWeight(m, e) != b.getWeight(m, e)) return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    const string locations = argc > 1 ? argv[1] : "../docs/Locations.csv";
+    const string distances = argc > 2 ? argv[2] : "../docs/Distances.csv";
+    DataReader reader;
+
+    Graph<int> parsed;
+    auto begin = chrono::steady_clock::now();
+    reader.readLocations(locations, parsed);
+    auto middle = chrono::steady_clock::now();
+    reader.readDistances(distances, parsed);
+    auto end = chrono::steady_clock::now();
+    double oldLocations = chrono::duration<double, milli>(middle - begin).count();
+    double oldDistances = chrono::duration<double, milli>(end - middle).count();
+
+    Graph<int> mapped;
+    string error;
+    begin = chrono::steady_clock::now();
+    bool ok = reader.loadLocations(locations, mapped, error);
+    middle = chrono::steady_clock::now();
+    ok = ok && reader.loadDistances(distances, mapped, error);
+    end = chrono::steady_clock::now();
+    if (!ok) {
+        cerr << error << endl;
+        return 1;
+    }
+    double newLocations = chrono::duration<double, milli>(middle - begin).count();
+    double newDistances = chrono::duration<double, milli>(end - middle).count();
+
+    cout << "vertices: " << parsed.getNumVertex() << endl;
+    cout << "readLocations " << oldLocations << " ms, loadLocations " << newLocations << " ms" << endl;
+    cout << "readDistances " << oldDistances << " ms, loadDistances " << newDistances << " ms" << endl;
+    cout << "same graph: " << (sameGraph(parsed, mapped) ? "yes" : "NO") << endl;
+    const GraphMemory memory = mapped.getMemoryUsage();
+    cout << "memory: " << memory.total() << " bytes for " << memory.vertices << " vertices and " << memory.edges
+         << " edges (vertices " << memory.vertexBytes << ", edges " << memory.edgeBytes << ", adjacency "
+         << memory.adjacencyBytes << ", metadata " << memory.metadataBytes << ", strings " << memory.stringBytes
+         << " (" << memory.removedStringBytes << " removed), indexes " << memory.indexBytes << ")" << endl;
+
+    const unsigned maxThreads = argc > 3 ? stoi(argv[3]) : max(1u, thread::hardware_concurrency());
+    begin = chrono::steady_clock::now();
+    const CsrGraph expected(mapped);
+    end = chrono::steady_clock::now();
+    cout << "CsrGraph(graph) " << chrono::duration<double, milli>(end - begin).count() << " ms" << endl;
+    Graph<int> locationsOnly;
+    reader.loadLocations(locations, locationsOnly, error);
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        CsrGraph network;
+        begin = chrono::steady_clock::now();
+        ok = reader.loadDistancesParallel(distances, locationsOnly, network, threads, error);
+        end = chrono::steady_clock::now();
+        if (!ok) {
+            cerr << error << endl;
+            return 1;
+        }
+        cout << "loadDistancesParallel (" << threads << " threads) " << chrono::duration<double, milli>(end - begin).count()
+             << " ms, same network: " << (sameNetwork(expected, network) ? "yes" : "NO") << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include "../headers/DataReader.h"
+#include "../headers/Dijsktra.h"
+
+/*
+ * Micro-benchmark of the priority queues of SearchQueue.h: full single-source Dijkstra searches from random
+ * sources, with every queue, on the bundled map and on a synthetic grid. Distances are checked against BinaryHeap.
+ * Usage: `queue_bench [docs directory] [grid side] [sources]` (defaults: ../docs, 1000 for 1M vertices, 5).
+ */
+
+using namespace std;
+
+template <class Queue>
+static double timeSearches(const CsrGraph &g, const vector<int> &sources, int mode, vector<double> &dist) {
+    Dijkstra dijkstra;
+    SearchWorkspace ws;
+    ws.setAvoided(&g, {}, {});
+    dist.clear();
+    auto begin = chrono::steady_clock::now();
+    for (int s : sources) {
+        dijkstra.search<Queue>(&g, ws, ws.tree, s, mode);
+        for (int v = 0; v < g.getNumVertex(); v++) dist.push_back(ws.tree.getDist(v));
+    }
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count() / sources.size();
+}
+
+static void run(const string &name, const CsrGraph &g, int mode, unsigned numSources) {
+    mt19937 rng(42);
+    vector<int> sources;
+    for (unsigned i = 0; i < numSources; i++) sources.push_back(rng() % g.getNumVertex());
+
+    vector<double> expected, dist;
+    double binary = timeSearches<BinaryHeap>(g, sources, mode, expected);
+    double quaternary = timeSearches<QuaternaryHeap>(g, sources, mode, dist);
+    bool same = dist == expected;
+    double radix = timeSearches<RadixHeap>(g, sources, mode, dist);
+    same = same && dist == expected;
+
+    cout << name << " (" << g.getNumVertex() << " vertices, " << g.getNumEdges(mode) << " edges): "
+         << "binary " << binary << " ms, 4-ary " << quaternary << " ms, radix " << radix << " ms per search"
+         << (same ? "" : " [DISTANCES DIFFER]") << endl;
+}
+
+int main(int argc, char *argv[]) {
+    const string docs = argc > 1 ? argv[1] : "../docs";
+    const int side = argc > 2 ? stoi(argv[2]) : 1000;
+    const unsigned sources = argc > 3 ? stoul(argv[3]) : 5;
+
+    Graph<int> map;
+    DataReader reader;
+    reader.readLocations(docs + "/Locations.csv", map);
+    reader.readDistances(docs + "/Distances.csv", map);
+    CsrGraph network(map);
+    run("docs driving", network, CsrGraph::modeIndex(TransportMode::DRIVING), 200);
+    run("docs walking", network, CsrGraph::modeIndex(TransportMode::WALKING), 200);
+
+    // side x side grid with random integer minutes, like Distances.csv
+    Graph<int> grid;
+    mt19937 rng(7);
+    for (int i = 0; i < side * side; i++) {
+        grid.addVertex("V" + to_string(i), i + 1, "G" + to_string(i), false);
+    }
+    for (int r = 0; r < side; r++) {
+        for (int c = 0; c < side; c++) {
+            int v = r * side + c;
+            if (c + 1 < side) grid.addBidirectionalEdge("G" + to_string(v), "G" + to_string(v + 1), 1 + rng() % 10, TransportMode::DRIVING);
+            if (r + 1 < side) grid.addBidirectionalEdge("G" + to_string(v), "G" + to_string(v + side), 1 + rng() % 10, TransportMode::DRIVING);
+        }
+    }
+    CsrGraph gridNetwork(grid);
+    run("grid", gridNetwork, CsrGraph::modeIndex(TransportMode::DRIVING), sources);
+    return 0;
+}
@@ -0,0 +1,394 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include "../headers/AStar.h"
+#include "../headers/ContractionHierarchy.h"
+#include "../headers/DataReader.h"
+#include "../headers/Dijsktra.h"
+#include "../headers/DriveWalkSearch.h"
+#include "../headers/MapGenerator.h"
+#include "../headers/MutablePriorityQueue.h"
+#include "../headers/SearchQueue.h"
+
+/*
+ * Routing benchmark suite, reporting JSON to compare versions: loading (loadLocations and loadDistancesParallel),
+ * Dijkstra::bestPath in both modes, bestPath with avoided nodes and edges, bestPathDriveWalk and the operations of
+ * MutablePriorityQueue, on the bundled map and on synthetic grid and random geometric maps (see MapGenerator).
+ * Dijkstra::kShortestPaths finds the alternative routes of the driving queries: the node-disjoint one of the menus
+ * (k = 2) and five loopless ones; unreachable counts the queries with fewer than k paths, and mismatches those whose
+ * paths do not start with the best one, are out of order or repeat a node.
+ * DriveWalkSearch runs the driving-walking queries next to bestPathDriveWalk, counting the queries where the message,
+ * the driving or walking time of the best route or the time of the second one differ.
+ * The other point-to-point engines (Dijkstra::bestPathBidirectional, AStar, and ContractionHierarchy saved and loaded
+ * back, without restricted queries) run the same queries next to bestPath, reporting the vertices they settle and
+ * counting the queries whose cost differs from that of bestPath.
+ * Queries are drawn at random with a fixed seed, so two versions run the same queries; the checksum of each
+ * benchmark is the sum of the weights found, which must not change between versions.
+ * Usage: `routing_bench [--docs dir] [--grid vertices] [--geometric vertices] [--queries n] [--max-walking minutes]
+ * [--seed n] [--out file]` (defaults: ../docs, 10000, 10000, 200, 20, 1, standard output). A size of 0 skips the map.
+ */
+
+using namespace std;
+
+namespace {
+    struct Options {
+        string docs = "../docs";
+        unsigned grid = 10000, geometric = 10000, queries = 200;
+        int maxWalking = 20;
+        uint64_t seed = 1;
+        string out;
+    };
+
+    struct Result {
+        Result(string dataset, string benchmark) : dataset(std::move(dataset)), benchmark(std::move(benchmark)) {}
+
+        string dataset, benchmark;
+        vector<double> times; // microseconds, one per iteration
+        double checksum = 0; // sum of the weights found
+        unsigned unreachable = 0; // queries without a path
+        double settled = 0; // vertices settled by the searches, summed over the iterations
+        unsigned mismatches = 0; // queries whose cost differs from that of Dijkstra::bestPath
+    };
+
+    struct Query {
+        int source, destination;
+        std::vector<int> avoidNodes; // restricted queries only
+        std::vector<std::pair<int, int>> avoidEdges;
+    };
+
+    // a point-to-point engine, returning the path found and adding the vertices it settled to `settled`
+    using Engine = std::function<Path(SearchWorkspace &ws, const Query &q, TransportMode mode, double &settled)>;
+
+    struct Dataset {
+        explicit Dataset(string name) : name(std::move(name)) {}
+
+        string name;
+        DataReader reader;
+        Graph<int> map;
+        CsrGraph network;
+    };
+}
+
+static double elapsed(chrono::steady_clock::time_point begin) {
+    return chrono::duration<double, micro>(chrono::steady_clock::now() - begin).count();
+}
+
+static double percentile(vector<double> sorted, double p) {
+    if (sorted.empty()) return 0;
+    sort(sorted.begin(), sorted.end());
+    return sorted[min(sorted.size() - 1, (size_t) (p / 100 * sorted.size()))];
+}
+
+static string queueName() {
+#if defined(ROUTING_QUEUE_QUATERNARY)
+    return "quaternary";
+#elif defined(ROUTING_QUEUE_RADIX)
+    return "radix";
+#else
+    return "binary";
+#endif
+}
+
+// loads a map as Menu::readGraph does, timing the whole load
+static bool load(Dataset &d, const string &locations, const string &distances, vector<Result> &results) {
+    string error;
+    Result r(d.name, "load");
+    auto begin = chrono::steady_clock::now();
+    bool loaded = d.reader.loadLocations(locations, d.map, error)
+                  && d.reader.loadDistancesParallel(distances, d.map, d.network, 0, error);
+    r.times.push_back(elapsed(begin));
+    if (!loaded) {
+        cerr << d.name << ": " << error << endl;
+        return false;
+    }
+    r.checksum = d.network.getNumVertex() + d.network.getNumEdges(0) + d.network.getNumEdges(1);
+    results.push_back(r);
+    return true;
+}
+
+/*
+ * Runs the unrestricted queries in both modes and the restricted ones in driving mode with an engine, as
+ * `<name>_driving`, `<name>_walking` and `<name>_restricted` (skipped if `restricted` is empty). The costs found are
+ * compared with `expected` unless it is empty, in which case they are stored there.
+ */
+static void runEngine(const Dataset &d, const string &name, const vector<Query> &queries, const vector<Query> &restricted,
+                      const Engine &engine, vector<double> &expected, vector<Result> &results) {
+    SearchWorkspace ws;
+    const bool compare = !expected.empty();
+    size_t k = 0;
+    auto run = [&](Result r, const vector<Query> &batch, TransportMode mode) {
+        for (const Query &q : batch) {
+            auto begin = chrono::steady_clock::now();
+            Path p = engine(ws, q, mode, r.settled);
+            r.times.push_back(elapsed(begin));
+            if (p.weight == INF) r.unreachable++;
+            else r.checksum += p.weight;
+            if (!compare) expected.push_back(p.weight);
+            else if (expected[k++] != p.weight) r.mismatches++;
+        }
+        results.push_back(r);
+    };
+    run(Result(d.name, name + "_driving"), queries, TransportMode::DRIVING);
+    run(Result(d.name, name + "_walking"), queries, TransportMode::WALKING);
+    if (!restricted.empty()) run(Result(d.name, name + "_restricted"), restricted, TransportMode::DRIVING);
+}
+
+static void runQueries(const Dataset &d, const Options &o, const filesystem::path &dir, vector<Result> &results) {
+    const CsrGraph &g = d.network;
+    const int n = g.getNumVertex();
+    Dijkstra dijkstra;
+    SearchWorkspace ws;
+    mt19937_64 rng(o.seed);
+    vector<Query> queries, restricted;
+    for (unsigned i = 0; i < o.queries; i++) {
+        // destination first, as the queries were drawn before, so that the checksums stay comparable
+        int destination = g.getID(rng() % n), source = g.getID(rng() % n);
+        queries.push_back({source, destination, {}, {}});
+    }
+
+    // five avoided nodes and the first driving segments of five other nodes per query
+    for (const Query &q : queries) {
+        Query r = q;
+        for (int i = 0; i < 5; i++) {
+            int v = rng() % n;
+            if (g.getID(v) != q.source && g.getID(v) != q.destination) r.avoidNodes.push_back(g.getID(v));
+            v = rng() % n;
+            int mode = CsrGraph::modeIndex(TransportMode::DRIVING);
+            if (g.edgeBegin(mode, v) < g.edgeEnd(mode, v)) {
+                r.avoidEdges.emplace_back(g.getID(v), g.getID(g.getTarget(mode, g.edgeBegin(mode, v))));
+            }
+        }
+        restricted.push_back(r);
+    }
+
+    vector<double> expected;
+    runEngine(d, "bestPath", queries, restricted, [&](SearchWorkspace &ws, const Query &q, TransportMode mode, double &settled) {
+        Path p = dijkstra.bestPath(&g, ws, q.source, q.destination, mode, q.avoidNodes, q.avoidEdges);
+        settled += ws.tree.settled;
+        return p;
+    }, expected, results);
+    runEngine(d, "bidirectional", queries, restricted, [&](SearchWorkspace &ws, const Query &q, TransportMode mode, double &settled) {
+        Path p = dijkstra.bestPathBidirectional(&g, ws, q.source, q.destination, mode, q.avoidNodes, q.avoidEdges);
+        settled += ws.tree.settled + ws.backward.settled;
+        return p;
+    }, expected, results);
+
+    // geographic bounds on the synthetic maps, which have coordinates, landmarks on docs/
+    Result prepare(d.name, "astar_prepare");
+    auto begin = chrono::steady_clock::now();
+    AStar astar(&g);
+    prepare.times.push_back(elapsed(begin));
+    results.push_back(prepare);
+    runEngine(d, "astar", queries, restricted, [&](SearchWorkspace &ws, const Query &q, TransportMode mode, double &settled) {
+        Path p = astar.bestPath(ws, q.source, q.destination, mode, q.avoidNodes, q.avoidEdges);
+        settled += ws.tree.settled;
+        return p;
+    }, expected, results);
+
+    // hierarchies are saved and loaded back, as project1 --ch reads those of ch_preprocess
+    Result contract(d.name, "ch_contract"), reload(d.name, "ch_load");
+    ContractionHierarchy hierarchies[CsrGraph::NUM_MODES];
+    for (int m = 0; m < CsrGraph::NUM_MODES; m++) {
+        const string fileName = (dir / (d.name + "_" + to_string(m) + ".ch")).string();
+        begin = chrono::steady_clock::now();
+        ContractionHierarchy ch(&g, m);
+        contract.times.push_back(elapsed(begin));
+        contract.checksum += ch.getNumShortcuts();
+        begin = chrono::steady_clock::now();
+        if (!ch.save(fileName) || !hierarchies[m].load(fileName, &g)) {
+            cerr << d.name << ": error saving or loading " << fileName << endl;
+            return;
+        }
+        reload.times.push_back(elapsed(begin));
+        reload.checksum += hierarchies[m].getNumEdges();
+    }
+    results.push_back(contract);
+    results.push_back(reload);
+    runEngine(d, "ch", queries, {}, [&](SearchWorkspace &ws, const Query &q, TransportMode mode, double &settled) {
+        Path p = hierarchies[CsrGraph::modeIndex(mode)].bestPath(ws, q.source, q.destination);
+        settled += ws.tree.settled + ws.backward.settled;
+        return p;
+    }, expected, results);
+
+    // the best paths are given, so only the alternatives are timed; the checksum adds up every path found
+    for (auto [name, k, disjointness] : {make_tuple("kShortestPaths_disjoint_k2", 2u, Disjointness::NODE_DISJOINT),
+                                         make_tuple("kShortestPaths_loopless_k5", 5u, Disjointness::LOOPLESS)}) {
+        Result r(d.name, name);
+        for (const Query &q : queries) {
+            Path best = dijkstra.bestPath(&g, ws, q.source, q.destination, TransportMode::DRIVING);
+            begin = chrono::steady_clock::now();
+            vector<Path> paths = dijkstra.kShortestPaths(&g, ws, best, TransportMode::DRIVING, k, disjointness);
+            r.times.push_back(elapsed(begin));
+            if (paths.size() < k) r.unreachable++;
+            bool valid = paths.empty() == (best.weight == INF) && (paths.empty() || paths[0].weight == best.weight);
+            for (size_t i = 0; i < paths.size(); i++) {
+                r.checksum += paths[i].weight;
+                vector<int> nodes = paths[i].path;
+                sort(nodes.begin(), nodes.end());
+                if (adjacent_find(nodes.begin(), nodes.end()) != nodes.end()) valid = false;
+                if (i > 0 && paths[i].weight < paths[i - 1].weight) valid = false;
+            }
+            if (!valid) r.mismatches++;
+        }
+        results.push_back(r);
+    }
+
+    Result driveWalk(d.name, "bestPathDriveWalk"), layered(d.name, "driveWalkSearch");
+    DriveWalkSearch search(&g);
+    auto addRoutes = [](Result &r, const auto &routes) {
+        if (routes.first.first.weight == INF || routes.first.second.weight == INF) r.unreachable++;
+        else r.checksum += routes.first.first.weight + routes.first.second.weight;
+    };
+    auto total = [](const pair<Path, Path> &route) { return route.first.weight + route.second.weight; };
+    for (const Query &q : queries) {
+        string message, layeredMessage;
+        begin = chrono::steady_clock::now();
+        auto routes = dijkstra.bestPathDriveWalk(&g, ws, q.source, q.destination, o.maxWalking, message);
+        driveWalk.times.push_back(elapsed(begin));
+        driveWalk.settled += ws.tree.settled + ws.backward.settled;
+        addRoutes(driveWalk, routes);
+
+        begin = chrono::steady_clock::now();
+        auto other = search.bestPath(ws, q.source, q.destination, o.maxWalking, layeredMessage);
+        layered.times.push_back(elapsed(begin));
+        layered.settled += ws.layered.settled;
+        addRoutes(layered, other);
+        // when several second routes tie, either engine may pick any of them
+        if (message != layeredMessage || routes.first.first.weight != other.first.first.weight
+            || routes.first.second.weight != other.first.second.weight || total(routes.second) != total(other.second)) layered.mismatches++;
+    }
+    results.push_back(driveWalk);
+    results.push_back(layered);
+}
+
+// inserts one node per vertex with random keys, decreases half of the keys and extracts every node
+static void runQueue(const Dataset &d, const Options &o, vector<Result> &results) {
+    const unsigned n = d.network.getNumVertex();
+    mt19937_64 rng(o.seed);
+    vector<SearchNode> nodes(n);
+    vector<unsigned> decreased(n / 2);
+    for (auto &v : decreased) v = rng() % n;
+
+    Result insert(d.name, "queue_insert"), decrease(d.name, "queue_decreaseKey"), extract(d.name, "queue_extractMin");
+    for (int round = 0; round < 5; round++) {
+        for (auto &node : nodes) node.key = rng() % 1000000;
+        MutablePriorityQueue<SearchNode> q;
+        auto begin = chrono::steady_clock::now();
+        for (auto &node : nodes) q.insert(&node);
+        insert.times.push_back(elapsed(begin) / n);
+        begin = chrono::steady_clock::now();
+        for (unsigned v : decreased) {
+            nodes[v].key /= 2;
+            q.decreaseKey(&nodes[v]);
+        }
+        decrease.times.push_back(elapsed(begin) / max(1u, n / 2));
+        begin = chrono::steady_clock::now();
+        // weighted by position, so that the checksum also depends on the order
+        for (unsigned i = 0; !q.empty(); i++) extract.checksum += q.extractMin()->key * (i % 7);
+        extract.times.push_back(elapsed(begin) / n);
+    }
+    results.push_back(insert);
+    results.push_back(decrease);
+    results.push_back(extract);
+}
+
+static void writeJson(ostream &out, const Options &o, const vector<Dataset *> &datasets, const vector<Result> &results) {
+    out << "{\n  \"suite\": \"routing_bench\",\n  \"queue\": \"" << queueName() << "\",\n  \"queries\": " << o.queries
+        << ",\n  \"max_walking\": " << o.maxWalking << ",\n  \"seed\": " << o.seed << ",\n  \"datasets\": [";
+    for (size_t i = 0; i < datasets.size(); i++) {
+        const CsrGraph &g = datasets[i]->network;
+        out << (i ? "," : "") << "\n    {\"name\": \"" << datasets[i]->name << "\", \"vertices\": " << g.getNumVertex()
+            << ", \"driving_edges\": " << g.getNumEdges(CsrGraph::modeIndex(TransportMode::DRIVING))
+            << ", \"walking_edges\": " << g.getNumEdges(CsrGraph::modeIndex(TransportMode::WALKING))
+            << ", \"coordinates\": " << (g.hasCoordinates() ? "true" : "false") << "}";
+    }
+    out << "\n  ],\n  \"results\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result &r = results[i];
+        double total = 0;
+        for (double t : r.times) total += t;
+        ostringstream line;
+        line.precision(4);
+        line << fixed << "{\"dataset\": \"" << r.dataset << "\", \"benchmark\": \"" << r.benchmark
+             << "\", \"iterations\": " << r.times.size() << ", \"mean_us\": " << total / max<size_t>(1, r.times.size())
+             << ", \"p50_us\": " << percentile(r.times, 50) << ", \"p95_us\": " << percentile(r.times, 95)
+             << ", \"max_us\": " << percentile(r.times, 100) << ", \"checksum\": " << r.checksum
+             << ", \"unreachable\": " << r.unreachable << ", \"settled_mean\": " << r.settled / max<size_t>(1, r.times.size())
+             << ", \"mismatches\": " << r.mismatches << "}";
+        out << (i ? "," : "") << "\n    " << line.str();
+    }
+    out << "\n  ]\n}" << endl;
+}
+
+int main(int argc, char *argv[]) {
+    Options o;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string option = argv[i], value = argv[i + 1];
+        if (option == "--docs") o.docs = value;
+        else if (option == "--grid") o.grid = stoul(value);
+        else if (option == "--geometric") o.geometric = stoul(value);
+        else if (option == "--queries") o.queries = stoul(value);
+        else if (option == "--max-walking") o.maxWalking = stoi(value);
+        else if (option == "--seed") o.seed = stoull(value);
+        else if (option == "--out") o.out = value;
+        else {
+            cerr << "Unknown option " << option << endl;
+            return 1;
+        }
+    }
+    if (argc % 2 == 0) {
+        cerr << "Missing value of option " << argv[argc - 1] << endl;
+        return 1;
+    }
+
+    vector<Dataset *> datasets;
+    vector<Result> results;
+    // temporary files: synthetic maps and contraction hierarchies
+    const filesystem::path dir = filesystem::temp_directory_path() / ("routing_bench_" + to_string(o.seed));
+    filesystem::create_directories(dir);
+    auto run = [&](Dataset *d, const string &locations, const string &distances) {
+        if (!load(*d, locations, distances, results)) return;
+        datasets.push_back(d);
+        if (o.queries > 0 && d->network.getNumVertex() > 0) runQueries(*d, o, dir, results);
+        runQueue(*d, o, results);
+    };
+
+    Dataset docs("docs"), grid("grid"), geometric("geometric");
+    if (!o.docs.empty()) run(&docs, o.docs + "/Locations.csv", o.docs + "/Distances.csv");
+
+    // synthetic maps are written to temporary files, so that loading them is measured as well
+    for (auto [d, topology, size] : {make_tuple(&grid, MapTopology::GRID, o.grid), make_tuple(&geometric, MapTopology::GEOMETRIC, o.geometric)}) {
+        if (size == 0) continue;
+        MapOptions options;
+        options.topology = topology;
+        options.vertices = size;
+        options.seed = o.seed;
+        const string locations = (dir / (d->name + "_locations.csv")).string(), distances = (dir / (d->name + "_distances.csv")).string();
+        string error;
+        if (!MapGenerator(options).write(locations, distances, error)) {
+            cerr << d->name << ": " << error << endl;
+            continue;
+        }
+        run(d, locations, distances);
+    }
+    filesystem::remove_all(dir);
+
+    if (o.out.empty()) {
+        writeJson(cout, o, datasets, results);
+        return 0;
+    }
+    ofstream out(o.out);
+    writeJson(out, o, datasets, results);
+    if (!out) {
+        cerr << "Error writing file " << o.out << endl;
+        return 1;
+    }
+    return 0;
+}
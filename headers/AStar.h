@@ -0,0 +1,97 @@
+#ifndef ASTAR_H
+#define ASTAR_H
+
+#include <vector>
+#include "CsrGraph.h"
+#include "Dijsktra.h"
+#include "SearchWorkspace.h"
+
+/**
+ * A* point-to-point searches over a CsrGraph. The remaining distance to the destination is bounded from below,
+ * separately for each transport mode, by the first available of:
+ * - GEOGRAPHIC: the great-circle distance times the lowest weight per kilometre of any edge of the mode
+ *   (i.e. divided by the highest speed found in the data), when every location has coordinates;
+ * - LANDMARKS (ALT): the triangle inequality over the exact distances to a few landmark vertices, computed once;
+ * - NONE: no estimate, the search behaves as a plain Dijkstra.
+ * Every bound is consistent, so the destination's distance is final when it is extracted from the queue.
+ * Avoided nodes and edges only make routes longer, so the bounds also hold for restricted queries.
+ * The object is immutable after construction and may be shared by several threads, each with its own workspace.
+ */
+class AStar {
+public:
+    enum class Bound { NONE, GEOGRAPHIC, LANDMARKS };
+
+    static constexpr unsigned DEFAULT_LANDMARKS = 8;
+
+    /**
+     * Constructs an A* engine without graph.
+     */
+    AStar();
+    /**
+     * Prepares the lower bounds of every transport mode of a graph.
+     * @param g Pointer to the graph, which must outlive the engine.
+     * @param landmarks Maximum number of landmarks per mode when coordinates are missing, 0 to disable them.
+     * @note Time Complexity: O(E) with coordinates, O(L (V + E) log V) with L landmarks.
+     */
+    explicit AStar(const CsrGraph *g, unsigned landmarks = DEFAULT_LANDMARKS);
+    /**
+     * Gets the kind of lower bound used by a transport mode.
+     * @param mode The mode index (see CsrGraph::modeIndex).
+     * @return The bound used by the searches of that mode.
+     */
+    Bound getBound(int mode) const { return bound[mode]; }
+    /**
+     * Gets a lower bound of the distance between two vertices.
+     * @param mode The mode index.
+     * @param v The index of the first vertex.
+     * @param t The index of the second vertex.
+     * @return A lower bound of the distance, `INF` if they are known to be disconnected.
+     * @note Time Complexity: O(1) for the geographic bound, O(L) for L landmarks.
+     */
+    double lowerBound(int mode, int v, int t) const;
+    /**
+     * Finds the best path between two nodes, honouring the same restrictions and returning the same cost as
+     * Dijkstra::bestPath; when several best paths exist it may return a different one.
+     * @param ws Workspace of the calling thread.
+     * @param start ID of the starting node.
+     * @param end ID of the ending node.
+     * @param transportation_mode Mode of transportation.
+     * @param avoid_nodes List of node IDs to avoid.
+     * @param avoid_edges List of edges to avoid.
+     * @return The best path (node IDs) and its weight, or an empty path with weight `INF` if there is none.
+     * @note Time Complexity: O((V + E) log V) in the worst case, usually settling only the nodes around the best path.
+     */
+    Path bestPath(SearchWorkspace &ws, const int &start, const int &end, TransportMode transportation_mode, const std::vector<int> &avoid_nodes={}, const std::vector<std::pair<int, int>> &avoid_edges={}) const;
+
+private:
+    const CsrGraph *g = nullptr;
+    Dijkstra dijkstra;
+    Bound bound[CsrGraph::NUM_MODES] = {Bound::NONE, Bound::NONE};
+    double costPerKm[CsrGraph::NUM_MODES] = {0, 0}; // lowest edge weight per kilometre of great-circle distance
+    unsigned landmarks[CsrGraph::NUM_MODES] = {0, 0}; // landmarks selected per mode
+    std::vector<double> landmarkDist[CsrGraph::NUM_MODES]; // distance between vertex v and landmark i at [v * landmarks + i]
+
+    /**
+     * Computes the lowest weight per kilometre of the edges of a mode.
+     * @param mode The mode index.
+     * @return The lowest ratio, 0 if some edge joins two distinct places with no cost.
+     */
+    double lowestCostPerKm(int mode) const;
+    /**
+     * Picks landmarks spread over the graph (each one the farthest from those already picked, favouring
+     * unreached components) and stores the distances from them to every vertex.
+     * @param mode The mode index.
+     * @param count Maximum number of landmarks.
+     * @note Time Complexity: O(count (V + E) log V).
+     */
+    void selectLandmarks(int mode, unsigned count);
+    /**
+     * Computes the great-circle distance between two vertices with the haversine formula.
+     * @param u The index of the first vertex.
+     * @param v The index of the second vertex.
+     * @return The distance in kilometres.
+     */
+    double greatCircle(int u, int v) const;
+};
+
+#endif //ASTAR_H
@@ -0,0 +1,76 @@
+#ifndef ALLPAIRS_H
+#define ALLPAIRS_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "CsrGraph.h"
+#include "Dijsktra.h"
+
+/**
+ * All-pairs shortest paths of one transport mode of a CsrGraph, precomputed by one Dijkstra search per vertex
+ * (run in parallel) into two contiguous row-major V x V arrays: the distances and the predecessor of each vertex
+ * in the shortest-path tree of each source. Unrestricted queries are then answered by following predecessors,
+ * giving the same paths as Dijkstra::bestPath.
+ * The tables take 12 V^2 bytes, so they are only built for graphs up to a configurable number of vertices.
+ * The object is immutable once built and may be shared by several threads.
+ */
+class AllPairs {
+public:
+    static constexpr int DEFAULT_MAX_VERTICES = 5000; // about 300 MB per mode
+
+    /**
+     * Constructs empty tables.
+     */
+    AllPairs();
+    /**
+     * Computes the tables of a transport mode, replacing the previous ones.
+     * @param g Pointer to the graph, which must outlive the tables.
+     * @param mode The mode index (see CsrGraph::modeIndex).
+     * @param threads Number of worker threads, `0` to use one per hardware thread.
+     * @param maxVertices Largest graph accepted.
+     * @param error Set to the reason of the failure, if any.
+     * @return `true` if the tables were built, `false` if the graph has too many vertices (the tables are left empty).
+     * @note Time Complexity: O(V (V + E) log V / threads).
+     */
+    bool build(const CsrGraph *g, int mode, unsigned threads, int maxVertices, std::string &error);
+    /**
+     * Checks if the tables were built.
+     * @return `true` if they were built, `false` otherwise.
+     */
+    bool isBuilt() const { return g != nullptr; }
+    /**
+     * Gets the mode index of the tables.
+     * @return The mode index, or `-1` if they are empty.
+     */
+    int getMode() const { return mode; }
+    /**
+     * Gets the memory used by the tables.
+     * @return The number of bytes.
+     */
+    size_t bytes() const;
+    /**
+     * Gets the distance between two vertices.
+     * @param s The index of the source.
+     * @param t The index of the target.
+     * @return The distance, `INF` if there is no path.
+     */
+    double getDist(int s, int t) const { return dist[(size_t) s * n + t]; }
+    /**
+     * Finds the best path between two nodes, without restrictions.
+     * @param start ID of the starting node.
+     * @param end ID of the ending node.
+     * @return The best path (node IDs) and its weight, or an empty path with weight `INF` if there is none.
+     * @note Time Complexity: O(path length).
+     */
+    Path bestPath(const int &start, const int &end) const;
+
+private:
+    const CsrGraph *g = nullptr;
+    int mode = -1;
+    size_t n = 0;
+    std::vector<double> dist; // dist[s * n + t]
+    std::vector<int> pred; // pred[s * n + t]: vertex before t in the path from s, -1 for s and unreachable vertices
+};
+
+#endif //ALLPAIRS_H
@@ -0,0 +1,195 @@
+/*
+ * CodeIndex.h
+ * Open-addressing hash table mapping location codes to vertex indices,
+ * used by Graph to find vertices by code in constant time.
+ * The table keeps views of the codes, not copies: Graph inserts the codes interned in its StringPool.
+ */
+
+#ifndef CODEINDEX_H
+#define CODEINDEX_H
+
+#include <string_view>
+#include <vector>
+
+class CodeIndex {
+public:
+    /**
+     * Constructs an empty CodeIndex.
+     */
+    CodeIndex();
+    /**
+     * Finds the index associated with a code.
+     * @param code The code to look up.
+     * @return The stored index, or `-1` if the code is not present.
+     * @note Time Complexity: O(1) on average.
+     */
+    int find(std::string_view code) const;
+    /**
+     * Associates a code with an index.
+     * @param code The code to insert, which must stay valid while it is in the table.
+     * @param index The index to store.
+     * @return `true` if the code was inserted, `false` if it was already present.
+     * @note Time Complexity: O(1) amortized.
+     */
+    bool insert(std::string_view code, int index);
+    /**
+     * Changes the index associated with a code already in the table, keeping its slot.
+     * @param code The code to update.
+     * @param index The new index.
+     * @return `true` if the code was updated, `false` if it was not present.
+     * @note Time Complexity: O(1) on average.
+     */
+    bool update(std::string_view code, int index);
+    /**
+     * Removes a code from the table.
+     * @param code The code to remove.
+     * @return `true` if the code was removed, `false` if it was not present.
+     */
+    bool erase(std::string_view code);
+    /**
+     * Removes every code from the table.
+     */
+    void clear();
+    /**
+     * Gets the number of codes in the table.
+     * @return The number of codes.
+     */
+    unsigned size() const;
+    /**
+     * Gets the memory used by the table.
+     * @return The number of bytes of the slots.
+     */
+    size_t bytes() const;
+
+private:
+    struct Slot {
+        std::string_view key;
+        int index = -1;
+        bool used = false;  // slot holds a live key
+        bool erased = false; // tombstone left by erase, keeps probe chains intact
+    };
+
+    std::vector<Slot> slots;
+    unsigned count = 0;
+    unsigned tombstones = 0;
+
+    static size_t hash(std::string_view key);
+    void rehash(size_t capacity);
+};
+
+inline CodeIndex::CodeIndex() : slots(16) {}
+
+/*
+ * FNV-1a, which is plenty for the short alphanumeric location codes.
+ */
+inline size_t CodeIndex::hash(std::string_view key) {
+    size_t h = 14695981039346656037ULL;
+    for (unsigned char c : key) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+inline int CodeIndex::find(std::string_view code) const {
+    size_t mask = slots.size() - 1;
+    for (size_t i = hash(code) & mask; ; i = (i + 1) & mask) {
+        const Slot &s = slots[i];
+        if (!s.used && !s.erased) return -1;
+        if (s.used && s.key == code) return s.index;
+    }
+}
+
+inline bool CodeIndex::insert(std::string_view code, int index) {
+    if ((count + tombstones + 1) * 10 > slots.size() * 7) {
+        // grow when live keys fill the table, otherwise just clear out the tombstones
+        rehash((count + 1) * 2 > slots.size() ? slots.size() * 2 : slots.size());
+    }
+    size_t mask = slots.size() - 1;
+    Slot *target = nullptr;
+    for (size_t i = hash(code) & mask; ; i = (i + 1) & mask) {
+        Slot &s = slots[i];
+        if (s.used) {
+            if (s.key == code) return false;
+        }
+        else if (s.erased) {
+            if (target == nullptr) target = &s;
+        }
+        else {
+            if (target == nullptr) target = &s;
+            break;
+        }
+    }
+    if (target->erased) tombstones--;
+    target->key = code;
+    target->index = index;
+    target->used = true;
+    target->erased = false;
+    count++;
+    return true;
+}
+
+inline bool CodeIndex::update(std::string_view code, int index) {
+    size_t mask = slots.size() - 1;
+    for (size_t i = hash(code) & mask; ; i = (i + 1) & mask) {
+        Slot &s = slots[i];
+        if (!s.used && !s.erased) return false;
+        if (s.used && s.key == code) {
+            s.index = index;
+            return true;
+        }
+    }
+}
+
+inline bool CodeIndex::erase(std::string_view code) {
+    size_t mask = slots.size() - 1;
+    for (size_t i = hash(code) & mask; ; i = (i + 1) & mask) {
+        Slot &s = slots[i];
+        if (!s.used && !s.erased) return false;
+        if (s.used && s.key == code) {
+            s.used = false;
+            s.erased = true;
+            s.key = {};
+            count--;
+            tombstones++;
+            return true;
+        }
+    }
+}
+
+inline void CodeIndex::clear() {
+    slots.assign(16, Slot());
+    count = 0;
+    tombstones = 0;
+}
+
+inline unsigned CodeIndex::size() const {
+    return count;
+}
+
+inline size_t CodeIndex::bytes() const {
+    return slots.capacity() * sizeof(Slot);
+}
+
+/*
+ * Rebuilds the table with the given power-of-two capacity, dropping tombstones.
+ */
+inline void CodeIndex::rehash(size_t capacity) {
+    std::vector<Slot> old;
+    old.swap(slots);
+    slots.resize(capacity);
+    count = 0;
+    tombstones = 0;
+    size_t mask = capacity - 1;
+    for (auto &s : old) {
+        if (!s.used) continue;
+        size_t i = hash(s.key) & mask;
+        while (slots[i].used) i = (i + 1) & mask;
+        slots[i].key = s.key;
+        slots[i].index = s.index;
+        slots[i].used = true;
+        count++;
+    }
+}
+
+#endif //CODEINDEX_H
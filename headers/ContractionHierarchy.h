@@ -0,0 +1,107 @@
+#ifndef CONTRACTIONHIERARCHY_H
+#define CONTRACTIONHIERARCHY_H
+
+#include <string>
+#include <vector>
+#include "CsrGraph.h"
+#include "Dijsktra.h"
+#include "SearchWorkspace.h"
+
+/**
+ * Contraction hierarchy of the edges of one transport mode of a CsrGraph.
+ * Preprocessing contracts the vertices one at a time (least important first), adding shortcut edges that keep
+ * the distances between the remaining vertices; queries then run a bidirectional search that only follows edges
+ * towards more important vertices, and unpack the shortcuts of the route found into the original vertices.
+ * The edges of Graph<int> are bidirectional, so a single upward graph serves both directions of the search.
+ * Queries return the same cost as Dijkstra::bestPath (possibly a different route when several are best) but
+ * do not support avoided nodes or edges.
+ */
+class ContractionHierarchy {
+public:
+    /**
+     * Constructs an empty hierarchy.
+     */
+    ContractionHierarchy();
+    /**
+     * Contracts the edges of a transport mode.
+     * @param g Pointer to the graph, which must outlive the hierarchy.
+     * @param mode The mode index (see CsrGraph::modeIndex).
+     * @note Time Complexity: depends on the graph; about O(V (d log V)) with bounded witness searches, d being the average degree.
+     */
+    ContractionHierarchy(const CsrGraph *g, int mode);
+    /**
+     * Gets the mode index of the contracted edges.
+     * @return The mode index, or `-1` for an empty hierarchy.
+     */
+    int getMode() const { return mode; }
+    /**
+     * Gets the number of edges of the upward graph, shortcuts included.
+     * @return The number of edges.
+     */
+    unsigned getNumEdges() const { return targets.size(); }
+    /**
+     * Gets the number of shortcut edges added by the preprocessing.
+     * @return The number of shortcuts.
+     */
+    unsigned getNumShortcuts() const;
+    /**
+     * Writes the hierarchy to a binary file, with a fingerprint of the edges it was built from.
+     * @param fileName Path to the file.
+     * @return `true` if the file was written, `false` otherwise.
+     */
+    bool save(const std::string &fileName) const;
+    /**
+     * Reads a hierarchy written by save.
+     * @param fileName Path to the file.
+     * @param g Pointer to the graph the hierarchy was built from.
+     * @return `true` if the file was read, is well formed and was built from the same vertices and edges of the mode
+     * (see save), `false` otherwise (the hierarchy is left empty).
+     * @note Time Complexity: O(V + E d) for the checks, d being the largest number of upward edges of a vertex.
+     */
+    bool load(const std::string &fileName, const CsrGraph *g);
+    /**
+     * Finds the best path between two nodes.
+     * @param ws Workspace of the calling thread (uses ws.tree and ws.backward).
+     * @param start ID of the starting node.
+     * @param end ID of the ending node.
+     * @return The best path (node IDs) and its weight, or an empty path with weight `INF` if there is none.
+     * @note Time Complexity: O((V' + E') log V'), V' and E' being the vertices and edges above start and end in the hierarchy, usually a tiny part of the graph.
+     */
+    Path bestPath(SearchWorkspace &ws, const int &start, const int &end) const;
+
+private:
+    struct Arc {
+        int to;
+        double weight;
+        int middle; // contracted vertex bypassed by a shortcut, -1 for an original edge
+    };
+
+    const CsrGraph *g = nullptr;
+    int mode = -1;
+    std::vector<int> rank; // contraction order of each vertex
+    std::vector<unsigned> offsets; // upward edges of vertex v are [offsets[v], offsets[v+1])
+    std::vector<int> targets;
+    std::vector<double> weights;
+    std::vector<int> middles;
+
+    /**
+     * Contracts every vertex and stores the upward graph.
+     */
+    void contract();
+    /**
+     * Finds the upward edge between two adjacent vertices of the hierarchy.
+     * @param u The index of one vertex.
+     * @param v The index of the other vertex.
+     * @return The position of the edge, stored at the less important of the two, or the end of its edges if there is none.
+     */
+    unsigned findArc(int u, int v) const;
+    /**
+     * Appends the original vertices of an edge of the hierarchy to a path, excluding u.
+     * @param u The index of the vertex where the edge starts.
+     * @param v The index of the vertex where the edge ends.
+     * @param path The path to extend with vertex IDs.
+     */
+    void unpack(int u, int v, std::vector<int> &path) const;
+};
+
+#endif //CONTRACTIONHIERARCHY_H
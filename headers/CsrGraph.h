@@ -0,0 +1,186 @@
+#ifndef CSRGRAPH_H
+#define CSRGRAPH_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "graph.h"
+
+/**
+ * Immutable compressed sparse row (CSR) snapshot of a loaded Graph<int>.
+ * Vertices are addressed by their position in the original vertex set and the edges of each
+ * transport mode are stored contiguously (offsets, targets and weights), keeping the order in
+ * which they appear in each vertex's adjacency list.
+ * Graph<int> only has bidirectional edges, so the outgoing edges of a vertex also describe its incoming edges.
+ * The arrays are either built from a Graph<int> or read in place from a memory-mapped snapshot file (see save
+ * and load); copies share them.
+ */
+class CsrGraph {
+public:
+    static constexpr int NUM_MODES = 2; // driving, walking
+    static constexpr uint32_t SNAPSHOT_VERSION = 2;
+
+    /**
+     * Edges of one transportation mode in CSR form: the edges of vertex v are [offsets[v], offsets[v+1]).
+     */
+    struct Edges {
+        std::vector<unsigned> offsets;
+        std::vector<int> targets; // vertex indexes
+        std::vector<double> weights;
+    };
+
+    /**
+     * Constructs an empty CsrGraph.
+     */
+    CsrGraph();
+    /**
+     * Builds a snapshot of a graph.
+     * @param g The graph to copy.
+     * @note Time Complexity: O(V + E).
+     */
+    explicit CsrGraph(const Graph<int> &g);
+    /**
+     * Builds a snapshot of the vertices of a graph with edges built elsewhere, ignoring the graph's own edges.
+     * @param g The graph whose vertices are copied.
+     * @param edges The edges of each mode, indexed by the positions of the vertices in g.
+     * @note Time Complexity: O(V), the edges are moved.
+     */
+    CsrGraph(const Graph<int> &g, std::array<Edges, NUM_MODES> edges);
+    /**
+     * Writes the graph to a binary snapshot file, which load can map without parsing.
+     * @param fileName Path to the file.
+     * @param error Set to the reason of the failure, if any.
+     * @return `true` if the file was written, `false` otherwise.
+     * @note Time Complexity: O(V + E).
+     */
+    bool save(const std::string &fileName, std::string &error) const;
+    /**
+     * Replaces the graph with a memory-mapped snapshot file written by save.
+     * The arrays are used in place; only their sizes and indexes are checked.
+     * @param fileName Path to the file.
+     * @param error Set to the reason of the failure, if any.
+     * @return `true` if the file was loaded, `false` otherwise (the graph is left unchanged).
+     * @note Time Complexity: O(V + E) for the checks, without copying or allocating per vertex.
+     */
+    bool load(const std::string &fileName, std::string &error);
+    /**
+     * Gets the index of the edge arrays used by a transportation mode.
+     * @param mode The transportation mode (driving or walking).
+     * @return The mode index, or `-1` if it is not a single mode.
+     */
+    static int modeIndex(TransportMode mode);
+    /**
+     * Gets the number of vertices in the snapshot.
+     * @return The number of vertices.
+     */
+    int getNumVertex() const;
+    /**
+     * Gets the number of edges of a transportation mode.
+     * @param mode The mode index.
+     * @return The number of edges.
+     */
+    unsigned getNumEdges(int mode) const;
+    /**
+     * Finds the index of the vertex with a given ID.
+     * @param id The ID of the vertex.
+     * @return The index of the vertex, or `-1` if there is no such vertex.
+     * @note Time Complexity: O(1) for the IDs of the dense index, O(log V) for the others.
+     */
+    int findVertexIdx(int id) const;
+    /**
+     * Gets the ID of the vertex at a given index.
+     * @param v The index of the vertex.
+     * @return The ID of the vertex.
+     */
+    int getID(int v) const { return ids[v]; }
+    /**
+     * Gets the name of the vertex at a given index.
+     * @param v The index of the vertex.
+     * @return The name of the location.
+     */
+    std::string_view getName(int v) const { return {names.data() + nameOffsets[v], nameOffsets[v + 1] - nameOffsets[v]}; }
+    /**
+     * Gets the code of the vertex at a given index.
+     * @param v The index of the vertex.
+     * @return The code of the location.
+     */
+    std::string_view getCode(int v) const { return {codes.data() + codeOffsets[v], codeOffsets[v + 1] - codeOffsets[v]}; }
+    /**
+     * Checks if the vertex at a given index has parking.
+     * @param v The index of the vertex.
+     * @return `true` if it has parking, `false` otherwise.
+     */
+    bool getParking(int v) const { return parking[v]; }
+    /**
+     * Checks if the location of every vertex is known.
+     * @return `true` if all vertices have a latitude and longitude, `false` otherwise.
+     */
+    bool hasCoordinates() const { return !latitude.empty(); }
+    /**
+     * Gets the latitude of a vertex, only available if hasCoordinates().
+     * @param v The index of the vertex.
+     * @return The latitude in degrees.
+     */
+    double getLatitude(int v) const { return latitude[v]; }
+    /**
+     * Gets the longitude of a vertex, only available if hasCoordinates().
+     * @param v The index of the vertex.
+     * @return The longitude in degrees.
+     */
+    double getLongitude(int v) const { return longitude[v]; }
+    /**
+     * Gets the first outgoing edge of a vertex.
+     * @param mode The mode index.
+     * @param v The index of the vertex.
+     * @return The position of the first edge in the edge arrays.
+     */
+    unsigned edgeBegin(int mode, int v) const { return adj[mode].offsets[v]; }
+    /**
+     * Gets the position after the last outgoing edge of a vertex.
+     * @param mode The mode index.
+     * @param v The index of the vertex.
+     * @return The position after the last edge in the edge arrays.
+     */
+    unsigned edgeEnd(int mode, int v) const { return adj[mode].offsets[v + 1]; }
+    /**
+     * Gets the destination of an edge.
+     * @param mode The mode index.
+     * @param e The position of the edge.
+     * @return The index of the destination vertex.
+     */
+    int getTarget(int mode, unsigned e) const { return adj[mode].targets[e]; }
+    /**
+     * Gets the weight of an edge.
+     * @param mode The mode index.
+     * @param e The position of the edge.
+     * @return The weight of the edge.
+     */
+    double getWeight(int mode, unsigned e) const { return adj[mode].weights[e]; }
+
+private:
+    struct Arrays;
+
+    struct Adjacency {
+        std::span<const unsigned> offsets; // edges of vertex v are [offsets[v], offsets[v+1])
+        std::span<const int> targets;
+        std::span<const double> weights;
+    };
+
+    // views over the arrays kept alive by storage
+    std::span<const int> ids; // vertex index -> ID
+    std::span<const int> idIndex; // ID -> vertex index, -1 if absent, for the IDs below IdIndex::denseLimit(V)
+    std::span<const int> sparseIndex; // vertex indexes of the other IDs, sorted by ID
+    std::span<const char> parking;
+    std::span<const double> latitude, longitude; // empty unless every vertex has coordinates
+    std::span<const unsigned> nameOffsets, codeOffsets; // name of vertex v is names[nameOffsets[v], nameOffsets[v+1])
+    std::span<const char> names, codes;
+    Adjacency adj[NUM_MODES];
+
+    std::shared_ptr<const void> storage; // the Arrays built from a graph, or the mapped snapshot file
+};
+
+#endif //CSRGRAPH_H
@@ -2,6 +2,29 @@
 #define DATAREADER_H
 #include <string>
 #include "graph.h"
+#include "CsrGraph.h"
+
+/**
+ * A route planning request read in batch mode.
+ */
+struct RouteRequest {
+    TransportMode mode = TransportMode::NONE;
+    int source = -1;
+    int destination = -1;
+    std::vector<int> avoidNodes;
+    std::vector<std::pair<int, int>> avoidSegments;
+    int includeNode = -1; // -1 if no node must be included
+    int maxWalking = 0;
+};
+
+/**
+ * A distance matrix request: the travel times of one mode from every source to every target.
+ */
+struct MatrixRequest {
+    TransportMode mode = TransportMode::NONE;
+    std::vector<int> sources; // node IDs
+    std::vector<int> targets; // node IDs
+};
 
 class DataReader {
     public:
@@ -15,6 +38,8 @@ class DataReader {
     ~DataReader();
     /**
      * Reads location data from a file and populates the graph.
+     * Besides the Location, Id, Code and Parking columns, the file may have Latitude and Longitude columns;
+     * locations with an empty value are left without coordinates.
      * @param fileName Path to the file containing location data.
      * @param graph Reference to the graph to populate.
      */
@@ -25,20 +50,57 @@ class DataReader {
      * @param graph Reference to the graph to populate.
      */
     void readDistances(const std::string& fileName, Graph<int>& graph);
+    /**
+     * Reads location data like readLocations, from a memory-mapped file whose fields are parsed in place.
+     * Lines may end in `\n` or `\r\n`, and blank lines are skipped. A row whose ID or code is already taken is an error.
+     * @param fileName Path to the file containing location data.
+     * @param graph Reference to the graph to populate.
+     * @param error Set to the file, line and reason of the failure, if any.
+     * @return `true` if the whole file was read, `false` otherwise (the graph keeps the locations read before the error).
+     * @note Time Complexity: O(file size).
+     */
+    bool loadLocations(const std::string& fileName, Graph<int>& graph, std::string& error);
+    /**
+     * Reads distance data like readDistances, from a memory-mapped file whose fields are parsed in place.
+     * Lines may end in `\n` or `\r\n`, and blank lines are skipped.
+     * @param fileName Path to the file containing distance data.
+     * @param graph Reference to the graph to populate, with its locations already read.
+     * @param error Set to the file, line and reason of the failure, if any.
+     * @return `true` if the whole file was read, `false` otherwise (the graph keeps the edges read before the error).
+     * @note Time Complexity: O(file size).
+     */
+    bool loadDistances(const std::string& fileName, Graph<int>& graph, std::string& error);
+    /**
+     * Reads distance data straight into the route network, in parallel: the file is split into line-aligned chunks
+     * parsed by worker threads into their own edge buffers, and the adjacency arrays are built in a final
+     * counting sort by source vertex. The network is the same as CsrGraph(graph) after loadDistances, with the
+     * edges of each vertex in file order, but no Edge objects are created.
+     * @param fileName Path to the file containing distance data.
+     * @param graph The graph holding the locations (its edges are ignored).
+     * @param network Reference to the network to build; it is left unchanged on failure.
+     * @param threads Number of worker threads, 0 for one per hardware thread.
+     * @param error Set to the file, line and reason of the first failure, if any.
+     * @return `true` if the whole file was read, `false` otherwise.
+     * @note Time Complexity: O(file size / threads + V threads).
+     */
+    bool loadDistancesParallel(const std::string& fileName, const Graph<int>& graph, CsrGraph& network, unsigned threads, std::string& error);
+    /**
+     * Reads a distance matrix request, made of the lines `Mode:driving` (or `walking`), `Sources:<IDs>` and
+     * `Targets:<IDs>`, the IDs separated by commas.
+     * @param fileName Path to the request file.
+     * @param request Reference to the request to fill.
+     * @param error Set to the file, line and reason of the failure, if any.
+     * @return `true` if the request is complete, `false` otherwise.
+     * @note Time Complexity: O(file size).
+     */
+    bool readMatrixRequest(const std::string& fileName, MatrixRequest& request, std::string& error);
     /**
      * Reads input data from a file for batch processing.
+     * The file holds one or more requests (Mode, Source, Destination, ... lines) separated by blank lines.
      * @param inFile Path to the input file.
-     * @param mode Reference to store the transportation mode.
-     * @param source Reference to store the source vertex ID.
-     * @param destination Reference to store the destination vertex ID.
-     * @param avoidNodes Reference to store the list of nodes to avoid.
-     * @param avoidSegments Reference to store the list of edges to avoid.
-     * @param includeNode Reference to store the include node ID.
-     * @param maxWalking Reference to store the maximum walking time allowed.
-     */
-    void readInputFile(const std::string& inFile, std::string& mode,
-        int &source, int &destination, std::vector<int>& avoidNodes,
-        std::vector<std::pair<int, int>>& avoidSegments, int& includeNode, int& maxWalking);
+     * @param requests Reference to store the requests, in file order.
+     */
+    void readInputFile(const std::string& inFile, std::vector<RouteRequest>& requests);
 };
 
 #endif //DATAREADER_H
@@ -6,82 +6,183 @@
 #define DIJSKTRA_H
 
 #include "graph.h"
+#include "CsrGraph.h"
+#include "SearchQueue.h"
+#include "SearchWorkspace.h"
 
 struct Path {
     std::vector<int> path;
     double weight;
 };
 
+/**
+ * How the paths returned by Dijkstra::kShortestPaths may overlap.
+ */
+enum class Disjointness {
+    LOOPLESS, // any loopless paths, in order of weight (Yen's algorithm)
+    /*
+     * Each path avoids every node and edge of the previous ones, except the endpoints. When the best route is a
+     * single edge, the alternative no longer repeats that edge as the original menus did: it is the best route
+     * without it (e.g. 484 to 74 by car: 484,74(2) then a 139-minute detour), or none.
+     */
+    NODE_DISJOINT
+};
+
+/**
+ * Route searches over a CsrGraph. The class holds no state and never modifies the graph: everything a search
+ * writes lives in the SearchWorkspace it is given, so queries can run concurrently with one workspace per thread.
+ */
 class Dijkstra {
     public:
         /**
-         * Reconstructs the shortest path from the start node to the end node.
+         * Reconstructs the shortest path from the source of the last search to a node.
          * @param g Pointer to the graph.
-         * @param start Starting node (source).
-         * @param end Ending node (destination).
-         * @param reversible Boolean value that indicates if path should be reversible.
-         * @return Vector containing the sequence of nodes in the shortest path.
-         * @note Timme Complexity:
+         * @param tree The search tree of the last search.
+         * @param end Index of the ending node (destination).
+         * @param reversible Boolean value that indicates if the path should go from the source to the end (`true`) or from the end to the source (`false`).
+         * @return Vector containing the sequence of node IDs in the shortest path, empty if the node was not reached.
+         * @note Time Complexity:
          * - Best-case: O(1) if the destination node is unreachable.
          * - Average-case: O(V) when reconstructing a typical path.
          * - Worst-case: O(V) if the graph is a single long path.
          */
-        std::vector<int> reconstructPath(Graph<int> *g, const int &start, const int &end, const bool reversible);
+        std::vector<int> reconstructPath(const CsrGraph *g, const SearchTree &tree, int end, bool reversible=true) const;
         /**
         * Finds the best path between two nodes in the graph.
         * @param g Pointer to the graph.
-        * @param start Starting node
-        * @param end Ending node.
+        * @param ws Workspace of the calling thread.
+        * @param start ID of the starting node.
+        * @param end ID of the ending node.
         * @param transportation_mode Mode of transportation.
-        * @param alternative Boolean flag to indicate if an alternative route is needed.
-        * @param avoid_nodes List of nodes to avoid.
-        * @param avoid_edges List of edges to avoid.
-        * @return Vector containing the best path between the nodes.
+        * @param avoid_nodes List of node IDs to avoid.
+        * @param avoid_edges List of edges to avoid, in both driving and walking modes.
+        * @return The best path (node IDs) and its weight, or an empty path with weight `INF` if there is none.
         * @note Time Complexity:
         * - Best-case: O(V log V) if the graph has no edges.
         * - Average-case: O((V + E) log V) in a typical graph.
         * - Worst-case: O((V + E) log V) in a fully connected graph.
         */
-        std::vector<int> bestPath(Graph<int> *g, const int &start, const int &end, const std::string &transportation_mode, bool alternative=false, const std::vector<int> &avoid_nodes={}, const std::vector<std::pair<int, int>> &avoid_edges={});
+        Path bestPath(const CsrGraph *g, SearchWorkspace &ws, const int &start, const int &end, TransportMode transportation_mode, const std::vector<int> &avoid_nodes={}, const std::vector<std::pair<int, int>> &avoid_edges={}) const;
+        /**
+         * Finds the best path between two nodes with a bidirectional search: one search grows from the start over
+         * outgoing edges, the other from the end over incoming edges, and both stop once no shorter path can
+         * be found through their frontiers. Honours the same restrictions and returns the same cost as bestPath,
+         * usually settling far fewer nodes; when several best paths exist it may return a different one.
+         * @param g Pointer to the graph.
+         * @param ws Workspace of the calling thread (uses ws.tree and ws.backward).
+         * @param start ID of the starting node.
+         * @param end ID of the ending node.
+         * @param transportation_mode Mode of transportation.
+         * @param avoid_nodes List of node IDs to avoid.
+         * @param avoid_edges List of edges to avoid, in both driving and walking modes.
+         * @return The best path (node IDs) and its weight, or an empty path with weight `INF` if there is none.
+         * @note Time Complexity: O((V + E) log V) in the worst case.
+         */
+        Path bestPathBidirectional(const CsrGraph *g, SearchWorkspace &ws, const int &start, const int &end, TransportMode transportation_mode, const std::vector<int> &avoid_nodes={}, const std::vector<std::pair<int, int>> &avoid_edges={}) const;
+        /**
+         * Finds the k best paths between two nodes, in order of weight, starting from the best path.
+         * LOOPLESS paths are found with Yen's algorithm, deviating each new path only from its own deviation node
+         * onwards (Lawler's rule) and reusing the shortest-path tree towards the end node as the deviation whenever
+         * it respects the restrictions, so a new search is only run for the other deviations.
+         * NODE_DISJOINT paths are found one at a time, each avoiding the nodes and edges of the previous ones;
+         * the second one is the alternative route of the menus.
+         * @param g Pointer to the graph.
+         * @param ws Workspace of the calling thread (uses ws.tree and ws.backward).
+         * @param best The best path between the two nodes (see bestPath), found with the same restrictions.
+         * @param transportation_mode Mode of transportation (driving or walking).
+         * @param k Maximum number of paths.
+         * @param disjointness How the paths may overlap.
+         * @param avoid_nodes List of node IDs to avoid.
+         * @param avoid_edges List of edges to avoid.
+         * @return Up to k paths (node IDs) and their weights, best first; fewer if there are no more, none if best is empty.
+         * @note Time Complexity: O(k L (V + E) log V) in the worst case, L being the number of nodes of the paths.
+         */
+        std::vector<Path> kShortestPaths(const CsrGraph *g, SearchWorkspace &ws, const Path &best, TransportMode transportation_mode, unsigned k, Disjointness disjointness, const std::vector<int> &avoid_nodes={}, const std::vector<std::pair<int, int>> &avoid_edges={}) const;
+        /**
+         * Finds the distances from one node to several others with a single search, which stops as soon as every
+         * target is settled.
+         * @param g Pointer to the graph.
+         * @param ws Workspace of the calling thread.
+         * @param start ID of the starting node.
+         * @param targets IDs of the target nodes.
+         * @param transportation_mode Mode of transportation (driving or walking).
+         * @param avoid_nodes List of node IDs to avoid.
+         * @param avoid_edges List of edges to avoid.
+         * @return The distance to each target, in the order given, `INF` if it cannot be reached or is unknown.
+         * @note Time Complexity: O((V' + E') log V'), V' and E' being the nodes and edges closer than the farthest target.
+         */
+        std::vector<double> oneToMany(const CsrGraph *g, SearchWorkspace &ws, const int &start, const std::vector<int> &targets, TransportMode transportation_mode, const std::vector<int> &avoid_nodes={}, const std::vector<std::pair<int, int>> &avoid_edges={}) const;
+        /**
+         * Finds the distances from several nodes to several others: one oneToMany search per source, spread over
+         * worker threads, each with its own workspace.
+         * @param g Pointer to the graph.
+         * @param sources IDs of the source nodes.
+         * @param targets IDs of the target nodes.
+         * @param transportation_mode Mode of transportation (driving or walking).
+         * @param threads Number of worker threads, `0` to use one per hardware thread.
+         * @param avoid_nodes List of node IDs to avoid.
+         * @param avoid_edges List of edges to avoid.
+         * @return Dense row-major matrix: entry `i * targets.size() + j` is the distance from sources[i] to targets[j], `INF` if there is no path.
+         * @note Time Complexity: O(S (V + E) log V / threads) for S sources in the worst case.
+         */
+        std::vector<double> manyToMany(const CsrGraph *g, const std::vector<int> &sources, const std::vector<int> &targets, TransportMode transportation_mode, unsigned threads = 0, const std::vector<int> &avoid_nodes={}, const std::vector<std::pair<int, int>> &avoid_edges={}) const;
         /**
          * Finds the best combined driving and walking path between two nodes.
+         * If no route respects the restrictions, the search is repeated without walking limit nor avoided nodes and edges,
+         * and the message reports why.
+         * The driving search from the start and the walking search from the end only record distances; every parking
+         * node is scored by its driving plus walking time and only the two routes returned are reconstructed.
+         * With a cache in ws.walkingTables, the walking search of each destination and set of avoided nodes and
+         * edges is run once (without walking limit) and its table of parking times reused by later queries, which
+         * then only walk as far as the parking nodes chosen to rebuild their routes.
          * @param g Pointer to the graph.
-         * @param start Starting node.
-         * @param end Ending node.
+         * @param ws Workspace of the calling thread (uses ws.tree, ws.backward and ws.walkingTables).
+         * @param start ID of the starting node.
+         * @param end ID of the ending node.
          * @param max_walking The maximum walking time allowed.
          * @param message Reference to a message string describing the status.
-         * @param alternative Boolean flag to indicate if an alternative route is needed.
-         * @param avoid_nodes List of nodes to avoid.
+         * @param avoid_nodes List of node IDs to avoid.
          * @param avoid_edges List of edges to avoid.
-         * @return Pair of paths representing the driving and walking routes.
-         * @note Time Complexity:
-         * - Best-case: O((V + E) log V) if a parking spot is found quickly.
-         * - Average-case: O((V + E) log V + P V), where P is the number of parking nodes (it is significantly smaller than V).
-         * - Worst-case: O((V + E) log V + V^2) if every node is a parking node.
+         * @return Pair of the best and second-best (driving, walking) routes.
+         * @note Time Complexity: O((V + E) log V), plus O(V) to score the parking nodes and rebuild the two routes.
          */
-        std::pair<std::pair<Path, Path>, std::pair<Path, Path>> bestPathDriveWalk(Graph<int> *g, const int &start, const int &end, int max_walking, std::string &message, bool alternative, const std::vector<int> &avoid_nodes, const std::vector<std::pair<int, int>> &avoid_edges);
+        std::pair<std::pair<Path, Path>, std::pair<Path, Path>> bestPathDriveWalk(const CsrGraph *g, SearchWorkspace &ws, const int &start, const int &end, int max_walking, std::string &message, const std::vector<int> &avoid_nodes={}, const std::vector<std::pair<int, int>> &avoid_edges={}) const;
         /**
-        * Implements Dijkstra's algorithm to find the shortest path in the graph.
+        * Implements Dijkstra's algorithm to find the shortest paths from a node, skipping the nodes and edges avoided by the workspace.
+        * The search stops as soon as the target is settled, or when the next node is farther than the bound: the
+        * distances and paths of the settled nodes (every node within the bound) are final and the same as those of a
+        * full search, while farther nodes may keep a larger tentative distance.
         * @param g Pointer to the graph.
-        * @param start Starting node.
-         * @param transportation_mode Mode of transportation.
-         * @param alternative Boolean value indicating if an alternative route is needed or not.
-         * @param avoid_nodes List of nodes to avoid.
-         * @param avoid_edges List of edges to avoid.
-         * @note Time Complexity:
-         * - Best-case: O(V log V) if there are no edges.
-         * - Average-case: O((V + E) log V) in a typical graph.
-         * - Worst-case: O((V + E) log V) in a fully connected graph.
-         */
-        void dijkstra(Graph<int> *g, const int &start, const std::string &transportation_mode, bool alternative, const std::vector<int> &avoid_nodes, const std::vector<std::pair<int, int>> &avoid_edges);
+        * @param ws Workspace of the calling thread, with the avoided nodes and edges already set.
+        * @param tree Search tree to fill, usually ws.tree.
+        * @param start Index of the starting node.
+        * @param mode Mode index of the edges to use (see CsrGraph::modeIndex).
+        * @param target Index of the node whose path is wanted, `-1` to settle every reachable node.
+        * @param bound Largest distance of interest, `INF` for no limit.
+        * @note Time Complexity:
+        * - Best-case: O(1) if the target is the start.
+        * - Average-case: O((V' + E') log V'), V' and E' being the nodes and edges closer than the target or bound.
+        * - Worst-case: O((V + E) log V) in a fully connected graph.
+        */
+        void dijkstra(const CsrGraph *g, SearchWorkspace &ws, SearchTree &tree, int start, int mode, int target = -1, double bound = INF) const;
+        /**
+        * Dijkstra's algorithm with a given priority queue (see SearchQueue.h); dijkstra uses the one selected at
+        * compile time. Instantiated for BinaryHeap, QuaternaryHeap and RadixHeap.
+        * Parameters and complexity are the same as dijkstra.
+        */
+        template <class Queue>
+        void search(const CsrGraph *g, SearchWorkspace &ws, SearchTree &tree, int start, int mode, int target = -1, double bound = INF) const;
         /**
-        * Relaxes an edge in the graph updating the destination vertex's distance and path is shorter path is found.
-        * @param e Pointer to the edge to be relaxed
+        * Relaxes an edge updating the destination's distance and path if a shorter path is found.
+        * @param tree The search tree.
+        * @param u Index of the origin of the edge.
+        * @param v Index of the destination of the edge.
+        * @param weight Weight of the edge.
         * @return `true` if edge was relaxed, `false` otherwise
         * @note Time Complexity:
         * - O(1) in all cases.
         */
-        bool relax(Edge<int> *e);
+        bool relax(SearchTree &tree, int u, int v, double weight) const;
 };
 
 #endif //DIJSKTRA_H
@@ -0,0 +1,60 @@
+#ifndef DRIVEWALKSEARCH_H
+#define DRIVEWALKSEARCH_H
+
+#include <string>
+#include <utility>
+#include <vector>
+#include "CsrGraph.h"
+#include "Dijsktra.h"
+#include "SearchWorkspace.h"
+
+/**
+ * Driving-walking routes found by a single search over a layered state graph:
+ * - the walking layer holds the vertices reached on foot from the destination, within the walking time allowed;
+ * - a parking node of the walking layer transfers, at no cost, to the same vertex of the driving layer;
+ * - the driving layer then grows towards the start over the driving edges.
+ * The walking part of every route is settled first, so the walking limit is an exact bound on that layer.
+ * Each vertex of the driving layer keeps two states, the best routes through two different parking nodes, so the
+ * search ends once both states of the start are settled, usually long before the whole graph is explored.
+ * Returns the same costs and messages as Dijkstra::bestPathDriveWalk, ranking routes of equal time by longer
+ * walking as it does; when several second-best routes tie it may return a different one.
+ * The object is immutable and may be shared by several threads, each with its own workspace.
+ */
+class DriveWalkSearch {
+public:
+    /**
+     * Constructs a search without graph.
+     */
+    DriveWalkSearch();
+    /**
+     * Constructs a search over a graph.
+     * @param g Pointer to the graph, which must outlive the search.
+     */
+    explicit DriveWalkSearch(const CsrGraph *g);
+    /**
+     * Checks whether the search has a graph.
+     * @return `true` if it was constructed over a graph, `false` otherwise.
+     */
+    bool isReady() const { return g != nullptr; }
+    /**
+     * Finds the best combined driving and walking path between two nodes, and the best one through another parking node.
+     * If no route respects the restrictions, the search is repeated without walking limit nor avoided nodes and edges,
+     * and the message reports why, as in Dijkstra::bestPathDriveWalk.
+     * @param ws Workspace of the calling thread (uses ws.layered and ws.labelParking, and ws.backward when no route is found).
+     * @param start ID of the starting node.
+     * @param end ID of the ending node.
+     * @param max_walking The maximum walking time allowed.
+     * @param message Reference to a message string describing the status.
+     * @param avoid_nodes List of node IDs to avoid.
+     * @param avoid_edges List of edges to avoid.
+     * @return Pair of the best and second-best (driving, walking) routes.
+     * @note Time Complexity: O((V' + E') log V'), V' and E' being the states and edges closer than the second-best
+     * route; O((V + E) log V) when no route exists.
+     */
+    std::pair<std::pair<Path, Path>, std::pair<Path, Path>> bestPath(SearchWorkspace &ws, const int &start, const int &end, int max_walking, std::string &message, const std::vector<int> &avoid_nodes={}, const std::vector<std::pair<int, int>> &avoid_edges={}) const;
+
+private:
+    const CsrGraph *g = nullptr;
+};
+
+#endif //DRIVEWALKSEARCH_H
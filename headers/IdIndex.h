@@ -0,0 +1,120 @@
+/*
+ * IdIndex.h
+ * Map from location IDs to vertex indices, used by Graph to find vertices by ID in constant time.
+ * IDs are looked up in a dense array while they stay below a small multiple of the number of vertices
+ * (see denseLimit), so that a single large ID does not allocate memory in proportion to its value;
+ * the other IDs, negative ones included, go to a hash map.
+ */
+
+#ifndef IDINDEX_H
+#define IDINDEX_H
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+class IdIndex {
+public:
+    static constexpr size_t DENSE_FACTOR = 4; // IDs below DENSE_FACTOR times the number of vertices are dense
+    static constexpr size_t DENSE_MIN = 1024; // IDs below this are always dense
+
+    /**
+     * Gets the number of IDs, starting at 0, that are kept in a dense array for a given number of vertices.
+     * @param vertices The number of vertices.
+     * @return The size up to which the dense array may grow.
+     */
+    static size_t denseLimit(size_t vertices) { return std::max(DENSE_MIN, DENSE_FACTOR * vertices); }
+
+    /**
+     * Finds the index associated with an ID.
+     * @param id The ID to look up.
+     * @return The stored index, or `-1` if the ID is not present.
+     * @note Time Complexity: O(1) on average.
+     */
+    int find(int id) const;
+    /**
+     * Associates an ID with an index.
+     * @param id The ID to insert, which must not be present yet.
+     * @param index The index to store.
+     * @note Time Complexity: O(1) amortized.
+     */
+    void insert(int id, int index);
+    /**
+     * Changes the index of an ID already present.
+     * @param id The ID to update.
+     * @param index The new index.
+     * @return `true` if the ID was updated, `false` if it was not present.
+     * @note Time Complexity: O(1) on average.
+     */
+    bool update(int id, int index);
+    /**
+     * Removes an ID.
+     * @param id The ID to remove.
+     * @return `true` if the ID was removed, `false` if it was not present.
+     */
+    bool erase(int id);
+    /**
+     * Gets the memory used by the index.
+     * @return The number of bytes of the dense array and an estimate for the hash map.
+     */
+    size_t bytes() const;
+
+private:
+    std::vector<int> dense; // ID -> index, -1 if absent
+    std::unordered_map<int, int> sparse; // IDs outside the dense array when they were inserted
+    unsigned count = 0;
+
+    /**
+     * Finds where the index of an ID is stored.
+     * @param id The ID to look up.
+     * @return A pointer to the stored index, or `nullptr` if the ID is not present.
+     */
+    int *locate(int id);
+};
+
+inline int *IdIndex::locate(int id) {
+    if (id >= 0 && id < (int) dense.size() && dense[id] != -1) return &dense[id];
+    if (sparse.empty()) return nullptr;
+    auto it = sparse.find(id);
+    return it == sparse.end() ? nullptr : &it->second;
+}
+
+inline int IdIndex::find(int id) const {
+    if (id >= 0 && id < (int) dense.size() && dense[id] != -1) return dense[id];
+    if (sparse.empty()) return -1;
+    auto it = sparse.find(id);
+    return it == sparse.end() ? -1 : it->second;
+}
+
+inline void IdIndex::insert(int id, int index) {
+    if (id >= 0 && (size_t) id < denseLimit(count + 1)) {
+        if (id >= (int) dense.size()) dense.resize(id + 1, -1);
+        dense[id] = index;
+    }
+    else {
+        sparse[id] = index;
+    }
+    count++;
+}
+
+inline bool IdIndex::update(int id, int index) {
+    int *stored = locate(id);
+    if (stored == nullptr) return false;
+    *stored = index;
+    return true;
+}
+
+inline bool IdIndex::erase(int id) {
+    if (id >= 0 && id < (int) dense.size() && dense[id] != -1) dense[id] = -1;
+    else if (sparse.erase(id) == 0) return false;
+    count--;
+    return true;
+}
+
+inline size_t IdIndex::bytes() const {
+    // a node per ID and a pointer per bucket, as in the usual implementations
+    return dense.capacity() * sizeof(int) + sparse.size() * (2 * sizeof(int) + 2 * sizeof(void *))
+        + sparse.bucket_count() * sizeof(void *);
+}
+
+#endif //IDINDEX_H
@@ -0,0 +1,131 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*
+ * Opt-in instrumentation of the searches and loaders, compiled in only when ROUTING_INSTRUMENTATION is defined
+ * (CMake option ROUTING_INSTRUMENTATION). The counters of the hot paths go through the ROUTING_* macros at the end
+ * of this file, which expand to nothing otherwise, so a normal build runs exactly the same code as before.
+ * A StatsScope picks the QueryStats that the counters of the calling thread go to; without one they are dropped.
+ */
+
+/**
+ * Phases whose wall time and allocations are measured.
+ */
+enum class Phase {
+    PARSE, // DataReader reading a file
+    SEARCH, // Dijkstra::dijkstra, one call per search
+    RECONSTRUCT, // Dijkstra::reconstructPath
+};
+constexpr int NUM_PHASES = 3;
+
+/**
+ * Counters of one query, or of one load.
+ */
+struct QueryStats {
+    uint64_t settled = 0; // vertices extracted from the queue and expanded
+    uint64_t relaxations = 0; // edges that improved the distance of their destination
+    uint64_t pushes = 0, decreases = 0, pops = 0; // priority queue operations
+    uint64_t rows = 0; // rows parsed
+    uint64_t allocations = 0, allocatedBytes = 0; // calls to operator new during the phases
+    double phaseMicros[NUM_PHASES] = {}; // wall time of each phase
+    double totalMicros = 0; // wall time of the StatsScope
+};
+
+/**
+ * Makes a QueryStats the target of the counters of the calling thread while the scope exists.
+ * A nested scope takes over until it ends.
+ */
+class StatsScope {
+public:
+    /**
+     * Starts counting into stats, which is cleared.
+     * @param stats The stats to fill.
+     */
+    explicit StatsScope(QueryStats &stats);
+    /**
+     * Stops counting, records the wall time of the scope and restores the previous target.
+     */
+    ~StatsScope();
+    StatsScope(const StatsScope &) = delete;
+    StatsScope &operator=(const StatsScope &) = delete;
+    /**
+     * Gets the target of the counters of the calling thread.
+     * @return The stats of the innermost scope, or `nullptr` if there is none.
+     */
+    static QueryStats *current() { return active; }
+
+private:
+    static inline constinit thread_local QueryStats *active = nullptr;
+    QueryStats &stats;
+    QueryStats *previous;
+    std::chrono::steady_clock::time_point begin;
+};
+
+/**
+ * Adds the wall time and allocations of a phase, from construction to destruction, to the current stats.
+ * Allocations are the calls to operator new of the calling thread, which is only replaced with ROUTING_INSTRUMENTATION.
+ * Phases must not nest, or the inner one is counted twice.
+ */
+class PhaseTimer {
+public:
+    explicit PhaseTimer(Phase phase);
+    ~PhaseTimer();
+    PhaseTimer(const PhaseTimer &) = delete;
+    PhaseTimer &operator=(const PhaseTimer &) = delete;
+
+private:
+    QueryStats *stats;
+    Phase phase;
+    uint64_t allocations, allocatedBytes;
+    std::chrono::steady_clock::time_point begin;
+};
+
+/**
+ * Distribution of the stats of many queries, reported as percentiles.
+ */
+class StatsHistogram {
+public:
+    /**
+     * Adds the stats of one query.
+     * @param stats The stats.
+     */
+    void add(const QueryStats &stats);
+    /**
+     * Adds the stats of other queries.
+     * @param other The histogram to merge.
+     */
+    void merge(const StatsHistogram &other);
+    /**
+     * Gets the number of queries added.
+     * @return The number of queries.
+     */
+    size_t size() const { return queries.size(); }
+    /**
+     * Writes a table with the p50, p95 and p99 of every counter and phase time.
+     * @param out The output stream.
+     * @param title Title of the table.
+     * @note Time Complexity: O(Q log Q) for Q queries.
+     */
+    void print(std::ostream &out, const std::string &title) const;
+
+private:
+    std::vector<QueryStats> queries;
+};
+
+#ifdef ROUTING_INSTRUMENTATION
+#define ROUTING_COUNT(counter) ROUTING_COUNT_N(counter, 1)
+#define ROUTING_COUNT_N(counter, n) do { if (QueryStats *routingStats = StatsScope::current()) routingStats->counter += (n); } while (0)
+#define ROUTING_PHASE(phase) PhaseTimer routingPhase(phase)
+#else
+#define ROUTING_COUNT(counter) ((void) 0)
+#define ROUTING_COUNT_N(counter, n) ((void) 0)
+#define ROUTING_PHASE(phase) ((void) 0)
+#endif
+
+#endif //INSTRUMENTATION_H
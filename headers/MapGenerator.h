@@ -0,0 +1,80 @@
+#ifndef MAPGENERATOR_H
+#define MAPGENERATOR_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * Shape of the road network of a synthetic map.
+ */
+enum class MapTopology {
+    GRID, // square grid, each location linked to the ones on its right and below
+    GEOMETRIC // random geometric graph: random points linked to every point closer than a radius
+};
+
+/**
+ * Distribution of the number of segments per location of a GEOMETRIC map.
+ */
+enum class DegreeShape {
+    POISSON, // every location reaches as far, as in a plain random geometric graph
+    POWER_LAW // a few hubs reach much farther than the others, so the degrees have a heavy tail
+};
+
+/**
+ * Parameters of a synthetic map.
+ */
+struct MapOptions {
+    MapTopology topology = MapTopology::GEOMETRIC;
+    unsigned vertices = 10000;
+    double averageDegree = 6; // expected number of segments per location (GEOMETRIC only)
+    DegreeShape degreeShape = DegreeShape::POISSON; // GEOMETRIC only
+    double degreeExponent = 1.5; // POWER_LAW: P(degree > k) decays as k^-degreeExponent, must be greater than 1
+    double parkingDensity = 0.25; // probability of a location having parking
+    double noDriving = 0.05; // probability of a segment having X (no driving) as driving time
+    double noWalking = 0.02; // probability of a segment having X (no walking) as walking time, never both
+    double minDrivingSpeed = 15, maxDrivingSpeed = 40; // km/h, drawn per segment, traffic included
+    double walkingSpeed = 5; // km/h
+    uint64_t seed = 1;
+};
+
+/**
+ * Writes synthetic maps as Locations and Distances files in the format read by DataReader, with Latitude and
+ * Longitude columns. Location i (from 0) is named P<i>, has ID i + 1 and code C<i>.
+ * The locations are spread around Porto at a constant density, so segments are a few hundred meters long whatever
+ * the size of the map; travel times are in whole minutes, as in Distances.csv.
+ * The same options always produce the same files.
+ */
+class MapGenerator {
+public:
+    /**
+     * Constructs a generator.
+     * @param options Parameters of the maps.
+     */
+    explicit MapGenerator(const MapOptions &options);
+    /**
+     * Checks the options.
+     * @param error Set to the reason why the options are invalid, if they are.
+     * @return `true` if the options are valid, `false` otherwise.
+     */
+    bool validate(std::string &error) const;
+    /**
+     * Generates the map and writes its files, a row at a time.
+     * @param locationsFile Path of the Locations file.
+     * @param distancesFile Path of the Distances file.
+     * @param error Set to the reason of the failure, if any.
+     * @return `true` if both files were written, `false` otherwise (invalid options included).
+     * @note Time Complexity: O(V log V + E), using about 16 bytes per location besides the files.
+     */
+    bool write(const std::string &locationsFile, const std::string &distancesFile, std::string &error);
+    /**
+     * Gets the number of segments written by the last call to write.
+     * @return The number of rows of the Distances file.
+     */
+    uint64_t getNumSegments() const { return segments; }
+
+private:
+    MapOptions options;
+    uint64_t segments = 0;
+};
+
+#endif //MAPGENERATOR_H
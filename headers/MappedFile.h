@@ -0,0 +1,47 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * Read-only memory mapping of a whole file. The contents stay valid until the object is closed or destroyed.
+ */
+class MappedFile {
+public:
+    /**
+     * Constructs an object with no file.
+     */
+    MappedFile();
+    /**
+     * Unmaps the file.
+     */
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+    /**
+     * Maps a file, unmapping the previous one.
+     * @param fileName Path to the file.
+     * @param error Set to the reason of the failure, if any.
+     * @return `true` if the file was mapped, `false` otherwise.
+     */
+    bool open(const std::string &fileName, std::string &error);
+    /**
+     * Unmaps the file, if any.
+     */
+    void close();
+    /**
+     * Gets the contents of the file.
+     * @return A view of the mapped bytes, empty if there is no file.
+     */
+    std::string_view data() const { return {ptr, length}; }
+
+private:
+    const char *ptr = nullptr;
+    size_t length = 0;
+};
+
+#endif //MAPPEDFILE_H
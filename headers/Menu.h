@@ -7,20 +7,97 @@
 #include "graph.h"
 #include "DataReader.h"
 #include "Dijsktra.h"
+#include "CsrGraph.h"
+#include "SearchWorkspace.h"
+#include "WalkingTableCache.h"
+#include "RouteCache.h"
+#include "AllPairs.h"
+#include "AStar.h"
+#include "ContractionHierarchy.h"
+#include "DriveWalkSearch.h"
 #include <string>
 
+/**
+ * Search engines of the point-to-point routes of the menus and of batch mode (see Menu::setRouteEngine).
+ */
+enum class RouteEngine {
+    DIJKSTRA,      // Dijkstra::bestPath, the default
+    BIDIRECTIONAL, // Dijkstra::bestPathBidirectional
+    ASTAR          // AStar::bestPath, with the lower bounds prepared when the engine is selected or the graph read
+};
+
+/**
+ * Parses the name of a route engine, as given on the command line.
+ * @param str The engine name ("dijkstra", "bidirectional" or "astar").
+ * @param engine Reference to store the parsed engine.
+ * @return `true` if the name is valid, `false` otherwise.
+ */
+inline bool parseRouteEngine(const std::string &str, RouteEngine &engine) {
+    if (str == "dijkstra") engine = RouteEngine::DIJKSTRA;
+    else if (str == "bidirectional") engine = RouteEngine::BIDIRECTIONAL;
+    else if (str == "astar") engine = RouteEngine::ASTAR;
+    else return false;
+    return true;
+}
+
 class Menu {
 private:
-    Graph<int> graph;
+    CsrGraph network; // read-only graph used by the route searches
     DataReader reader;
     Dijkstra dijkstra;
+    SearchWorkspace workspace;
+    WalkingTableCache walkingTables; // walking searches of the driving-walking queries, shared by every workspace once enabled
+    RouteCache answers; // answers of the batch requests, so repeated requests are computed once
+    AllPairs allPairs[CsrGraph::NUM_MODES]; // optional all-pairs tables of each mode, see buildAllPairs
+    ContractionHierarchy hierarchies[CsrGraph::NUM_MODES]; // optional, see loadHierarchies
+    RouteEngine engine = RouteEngine::DIJKSTRA;
+    AStar astar; // lower bounds of the ASTAR engine, only prepared when it is selected
+    DriveWalkSearch layeredSearch; // driving-walking engine, without graph unless selected by setLayeredDriveWalk
+    Disjointness alternatives = Disjointness::NODE_DISJOINT; // how the alternative route may overlap the best one
+
+    /**
+     * Finds the best path between two nodes with the selected route engine.
+     * @param ws Workspace of the calling thread.
+     * @param source ID of the source node.
+     * @param destination ID of the destination node.
+     * @param mode Mode of transportation.
+     * @param avoid_nodes IDs of the nodes to avoid.
+     * @param avoid_edges Segments to avoid, as pairs of node IDs.
+     * @return The best path and its weight, or an empty path with weight `INF` if there is none.
+     */
+    Path routePath(SearchWorkspace &ws, int source, int destination, TransportMode mode,
+                   const std::vector<int> &avoid_nodes = {}, const std::vector<std::pair<int,int>> &avoid_edges = {}) const;
+    /**
+     * Finds the best driving-walking routes with the selected engine (see setLayeredDriveWalk).
+     * @param ws Workspace of the calling thread.
+     * @param source ID of the source node.
+     * @param destination ID of the destination node.
+     * @param maxWalking The maximum walking time allowed.
+     * @param message Reference to a message string describing the status.
+     * @param avoid_nodes IDs of the nodes to avoid.
+     * @param avoid_edges Segments to avoid, as pairs of node IDs.
+     * @return Pair of the best and second-best (driving, walking) routes.
+     */
+    std::pair<std::pair<Path, Path>, std::pair<Path, Path>> driveWalkPath(SearchWorkspace &ws, int source, int destination, int maxWalking, std::string &message,
+                                                                          const std::vector<int> &avoid_nodes, const std::vector<std::pair<int,int>> &avoid_edges) const;
+
+    /**
+     * Finds the best path between two nodes without restrictions, from the all-pairs tables if they were built,
+     * otherwise from the contraction hierarchies if they were loaded, otherwise with the selected route engine.
+     * @param ws Workspace of the calling thread.
+     * @param source ID of the source node.
+     * @param destination ID of the destination node.
+     * @param mode Mode of transportation.
+     * @return The best path and its weight, or an empty path with weight `INF` if there is none.
+     */
+    Path unrestrictedPath(SearchWorkspace &ws, int source, int destination, TransportMode mode) const;
 public:
     /**
      * Constructor for the Menu class.
      */
     Menu();
     /**
-     * Displays the main menu and processes user input choices.
+     * Displays the main menu and processes user input choices, once the graph is read (readGraph or loadSnapshot).
      */
     void MainMenu();
     /**
@@ -33,19 +110,96 @@ public:
     void RestrictedMenu();
     /**
      * Processes batch mode operations from input file and writes output to file.
+     * The input file may hold several requests separated by blank lines; they are answered in parallel
+     * and written to the output file in input order, also separated by blank lines.
+     * Repeated requests (same fields, avoided nodes and segments in any order) are answered from a cache.
+     * The statistics of the answer and walking table caches are printed at the end.
      * @param inFile Path to input file.
      * @param outFile Path to output file.
+     * @param threads Number of worker threads, `0` to use one per hardware thread.
+     */
+    void MenuBatchMode(const std::string& inFile, const std::string& outFile, unsigned threads = 0);
+    /**
+     * Answers one batch mode request.
+     * @param request The request.
+     * @param ws Workspace of the calling thread.
+     * @param out Stream to write the answer to.
      */
-    void MenuBatchMode(const std::string& inFile, const std::string& outFile);
+    void processBatchRequest(const RouteRequest &request, SearchWorkspace &ws, std::ostream &out) const;
+    /**
+     * Computes the distance matrix of a request file (see DataReader::readMatrixRequest) and writes it to a CSV
+     * file: a header row with the target IDs, then one row per source with its ID and the travel time to each
+     * target, `X` if there is no path.
+     * @param inFile Path to the request file.
+     * @param outFile Path to the output file.
+     * @param threads Number of worker threads, `0` to use one per hardware thread.
+     * @return `true` if the matrix was written, `false` otherwise (the error is printed).
+     */
+    bool MenuMatrixMode(const std::string& inFile, const std::string& outFile, unsigned threads = 0);
     /**
      * Displays the driving-walking mode menu and processes user input.
      */
     void MenuDrivingWalking();
 
     /**
-     * Reads the graph data from files.
+     * Reads the graph data from files and builds the snapshot used by the route searches.
+     * @return `true` if the files were read, `false` otherwise (the error is printed).
+     */
+    bool readGraph();
+    /**
+     * Maps a binary graph snapshot written by saveSnapshot, instead of reading the graph data files.
+     * @param fileName Path to the snapshot file.
+     * @return `true` if the snapshot was loaded, `false` otherwise (the error is printed).
      */
-    void readGraph();
+    bool loadSnapshot(const std::string &fileName);
+    /**
+     * Precomputes the all-pairs tables of driving and walking, so unrestricted queries are answered by lookups.
+     * Prints the memory used, or why the tables were not built.
+     * @param maxVertices Largest graph accepted.
+     * @param threads Number of worker threads, `0` to use one per hardware thread.
+     * @return `true` if the tables were built, `false` otherwise.
+     */
+    bool buildAllPairs(int maxVertices = AllPairs::DEFAULT_MAX_VERTICES, unsigned threads = 0);
+    /**
+     * Loads the contraction hierarchies written by ch_preprocess for the graph read, so that they answer the
+     * unrestricted queries (see ContractionHierarchy).
+     * @param prefix Output prefix given to ch_preprocess: the files are `<prefix>.driving.ch` and `<prefix>.walking.ch`.
+     * @return `true` if both were loaded, `false` otherwise (the error is printed and neither is used).
+     */
+    bool loadHierarchies(const std::string &prefix);
+    /**
+     * Selects the search engine of the best and restricted routes, Dijkstra::bestPath unless changed.
+     * Every engine finds routes of the same cost, but may pick another route among those of equal cost.
+     * ASTAR prepares its lower bounds on the graph read, and again whenever another graph is read.
+     * @param routeEngine The engine to use.
+     */
+    void setRouteEngine(RouteEngine routeEngine);
+    /**
+     * Selects the engine of the driving-walking routes: DriveWalkSearch, a single search over a layered graph,
+     * instead of Dijkstra::bestPathDriveWalk, which is used unless changed. Both find the same costs and messages.
+     * @param layered `true` to use DriveWalkSearch.
+     */
+    void setLayeredDriveWalk(bool layered);
+    /**
+     * Enables the cache of walking tables of Dijkstra::bestPathDriveWalk, off unless changed.
+     * A destination missing from the cache is searched without walking limit, so the cache only pays off when
+     * requests repeat destinations.
+     * @param enabled `true` to cache the walking tables.
+     */
+    void setWalkingCache(bool enabled);
+    /**
+     * Selects how the alternative route may overlap the best one (see Dijkstra::kShortestPaths): NODE_DISJOINT, the
+     * default, shares no node or edge with it but its endpoints, and is often missing (unlike the original menus, a
+     * best route made of a single edge is not repeated); LOOPLESS is the second best route.
+     * @param disjointness How the alternative route may overlap the best one.
+     */
+    void setAlternatives(Disjointness disjointness);
+    /**
+     * Writes the graph read by readGraph or loadSnapshot to a binary snapshot file.
+     * @param fileName Path to the snapshot file.
+     * @return `true` if the snapshot was written, `false` otherwise (the error is printed).
+     */
+    bool saveSnapshot(const std::string &fileName) const;
 
     /**
      * Gets an integer value from user input.
@@ -56,9 +210,9 @@ public:
     int getIntValue(const std::string &s, const bool &node);
     /**
      * Gets the transportation mode from user input.
-     * @return A string representing the selected transportation mode.
+     * @return The selected transportation mode (driving or walking).
      */
-    std::string getTransportationMode();
+    TransportMode getTransportationMode();
     /**
      * Gets restricted route parameters from user input.
      * @param avoid_nodes Reference to a vector of avoiding nodes.
@@ -74,12 +228,19 @@ public:
      * Displays information about the driving route.
      * @param source Source node.
      * @param destination Destination node.
-     * @param res Route result vector.
-     * @param avoid_edges Edges to be avoided.
+     * @param res Route found.
+     * @param avoid_edges Edges to be avoided. The edges of the route are added to it, unless it is an alternative route.
      * @param alternative Boolean indication if it is an alternative route or not
      * @param message Message to be displayed
      */
-    void displayInformationDriving(const int &source, const int &destination, const std::vector<int> &res, std::vector<std::pair<int, int>> &avoid_edges, const bool &alternative, const std::string &message);
+    void displayInformationDriving(const int &source, const int &destination, const Path &res, std::vector<std::pair<int, int>> &avoid_edges, const bool &alternative, const std::string &message);
+    /**
+     * Gets the nodes an alternative route must avoid: the given ones plus every node of the route except its last.
+     * @param avoid_nodes Nodes already avoided.
+     * @param route Route to deviate from.
+     * @return The list of nodes to avoid.
+     */
+    static std::vector<int> alternativeAvoidNodes(const std::vector<int> &avoid_nodes, const Path &route);
 };
 
 
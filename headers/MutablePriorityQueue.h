@@ -10,6 +10,7 @@
 #define DA_TP_CLASSES_MUTABLEPRIORITYQUEUE
 
 #include <vector>
+#include "Instrumentation.h"
 
 template <class T>
 class MutablePriorityQueue {
@@ -32,6 +33,11 @@ public:
      * @return Pointer to the element with the smallest priority.
      */
     T * extractMin();
+    /**
+     * Gets the element with the smallest priority without removing it.
+     * @return Pointer to the element with the smallest priority.
+     */
+    T * top();
 
     /**
      * Decreases the priority of an element and restores the heap property.
@@ -64,6 +70,7 @@ bool MutablePriorityQueue<T>::empty() {
 
 template <class T>
 T* MutablePriorityQueue<T>::extractMin() {
+    ROUTING_COUNT(pops);
     auto x = H[1];
     H[1] = H.back();
     H.pop_back();
@@ -72,14 +79,21 @@ T* MutablePriorityQueue<T>::extractMin() {
     return x;
 }
 
+template <class T>
+T* MutablePriorityQueue<T>::top() {
+    return H[1];
+}
+
 template <class T>
 void MutablePriorityQueue<T>::insert(T *x) {
+    ROUTING_COUNT(pushes);
     H.push_back(x);
     heapifyUp(H.size()-1);
 }
 
 template <class T>
 void MutablePriorityQueue<T>::decreaseKey(T *x) {
+    ROUTING_COUNT(decreases);
     heapifyUp(x->queueIndex);
 }
 
@@ -0,0 +1,114 @@
+/*
+ * ObjectPool.h
+ * Block allocator for the vertices and edges of Graph.
+ */
+
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Pool of objects of one type, placed one after the other in blocks of BLOCK_SIZE objects, in creation order.
+ * Destroyed objects leave their slot to the next object created; the pool releases every object and block at
+ * once when cleared or destroyed, instead of one allocation per object.
+ * Objects never move, so pointers to them stay valid until they are destroyed.
+ */
+template <class T>
+class ObjectPool {
+public:
+    static constexpr size_t BLOCK_SIZE = 1024; // objects per block
+
+    ObjectPool() = default;
+    ObjectPool(const ObjectPool &) = delete;
+    ObjectPool &operator=(const ObjectPool &) = delete;
+    /**
+     * Destroys every object left in the pool.
+     */
+    ~ObjectPool();
+    /**
+     * Constructs an object in the pool.
+     * @param args The arguments of the constructor of T.
+     * @return A pointer to the new object.
+     * @note Time Complexity: O(1), plus one allocation per BLOCK_SIZE objects.
+     */
+    template <class... Args>
+    T *create(Args &&... args);
+    /**
+     * Destroys an object of the pool, whose slot is reused by the next object created.
+     * @param object A pointer returned by create, not destroyed yet.
+     */
+    void destroy(T *object);
+    /**
+     * Destroys every object and releases the blocks.
+     * @note Time Complexity: O(n) for the destructors (none if T is trivially destructible), plus O(f log f) for the f free slots.
+     */
+    void clear();
+    /**
+     * Gets the number of objects in the pool.
+     * @return The number of objects created and not destroyed.
+     */
+    size_t size() const { return used - freeSlots.size(); }
+    /**
+     * Gets the memory reserved by the pool.
+     * @return The number of bytes of the blocks.
+     */
+    size_t bytes() const { return blocks.size() * BLOCK_SIZE * sizeof(T); }
+
+private:
+    struct alignas(T) Slot {
+        std::byte bytes[sizeof(T)];
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> blocks;
+    size_t used = 0; // slots handed out since the last clear, including the free ones
+    std::vector<T *> freeSlots;
+};
+
+template <class T>
+ObjectPool<T>::~ObjectPool() {
+    clear();
+}
+
+template <class T>
+template <class... Args>
+T *ObjectPool<T>::create(Args &&... args) {
+    void *slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        if (used == blocks.size() * BLOCK_SIZE) blocks.push_back(std::make_unique<Slot[]>(BLOCK_SIZE));
+        slot = &blocks[used / BLOCK_SIZE][used % BLOCK_SIZE];
+        used++;
+    }
+    return new (slot) T(std::forward<Args>(args)...);
+}
+
+template <class T>
+void ObjectPool<T>::destroy(T *object) {
+    object->~T();
+    freeSlots.push_back(object);
+}
+
+template <class T>
+void ObjectPool<T>::clear() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        std::sort(freeSlots.begin(), freeSlots.end());
+        for (size_t i = 0; i < used; i++) {
+            T *object = reinterpret_cast<T *>(&blocks[i / BLOCK_SIZE][i % BLOCK_SIZE]);
+            if (!std::binary_search(freeSlots.begin(), freeSlots.end(), object)) object->~T();
+        }
+    }
+    blocks.clear();
+    freeSlots.clear();
+    used = 0;
+}
+
+#endif //OBJECTPOOL_H
@@ -0,0 +1,93 @@
+#ifndef ROUTECACHE_H
+#define ROUTECACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "DataReader.h"
+
+/**
+ * Concurrent LRU cache of the answers to route requests, so repeated requests of a batch are answered once.
+ * Requests are identified by a canonical key (see makeKey) and spread over shards, each one with its own lock,
+ * list of entries (most recently used first) and share of the byte capacity.
+ * The answers belong to one graph and must be cleared when it changes.
+ */
+class RouteCache {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 32 << 20; // bytes
+    static constexpr unsigned DEFAULT_SHARDS = 16;
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t entries = 0;
+        size_t bytes = 0; // memory of the cached keys and answers
+        size_t capacity = 0;
+    };
+
+    /**
+     * Constructs an empty cache.
+     * @param capacity Maximum memory of the cached keys and answers, in bytes; 0 disables the cache.
+     * @param shards Number of shards.
+     */
+    explicit RouteCache(size_t capacity = DEFAULT_CAPACITY, unsigned shards = DEFAULT_SHARDS);
+    /**
+     * Builds the canonical key of a request: the fields that affect its answer, with the avoided nodes and
+     * segments sorted and without repetitions.
+     * @param request The request.
+     * @return The key.
+     * @note Time Complexity: O(A log A), A being the number of avoided nodes and segments.
+     */
+    static std::string makeKey(const RouteRequest &request);
+    /**
+     * Looks up the answer of a request, counting a hit or a miss.
+     * @param key The key of the request.
+     * @param answer Set to the answer if it is cached.
+     * @return `true` if the answer was found, `false` otherwise.
+     * @note Time Complexity: O(key and answer length).
+     */
+    bool find(const std::string &key, std::string &answer);
+    /**
+     * Adds the answer of a request, evicting the least recently used answers of its shard if needed.
+     * @param key The key of the request.
+     * @param answer The answer.
+     * @note Time Complexity: O(key and answer length) plus the evicted answers.
+     */
+    void insert(const std::string &key, const std::string &answer);
+    /**
+     * Removes every answer, e.g. after the graph changed. The counters are kept.
+     */
+    void clear();
+    /**
+     * Gets the counters and memory use of every shard together.
+     * @return The statistics.
+     */
+    Stats getStats() const;
+
+private:
+    struct Entry {
+        std::string key;
+        std::string answer;
+        size_t bytes;
+    };
+    struct Shard {
+        std::mutex mutex;
+        std::list<Entry> entries; // most recently used first
+        std::unordered_map<std::string_view, std::list<Entry>::iterator> index; // views of the keys in entries
+        Stats stats;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    size_t shardCapacity;
+
+    Shard &shardOf(const std::string &key) { return *shards[std::hash<std::string>()(key) % shards.size()]; }
+};
+
+#endif //ROUTECACHE_H
@@ -0,0 +1,176 @@
+#ifndef SEARCHQUEUE_H
+#define SEARCHQUEUE_H
+
+#include <bit>
+#include <cstdint>
+#include <vector>
+#include "Instrumentation.h"
+#include "MutablePriorityQueue.h"
+#include "SearchWorkspace.h"
+
+/*
+ * Priority queues of vertex indexes used by Dijkstra::search. They share one interface:
+ * - Queue(SearchTree &tree): the priority of vertex v is tree.node(v)->key;
+ * - push(v): inserts a vertex;
+ * - decrease(v): updates the position of a queued vertex after its key decreased;
+ * - pop(): removes and returns the vertex with the smallest key;
+ * - empty(): checks if there are no vertices left.
+ * The queue used by Dijkstra::dijkstra is chosen at compile time (SearchQueue, at the end of this file).
+ */
+
+/**
+ * Binary heap of pointers to the search nodes (MutablePriorityQueue), the original queue of the project.
+ * Ties between equal keys are broken exactly as before, so it is the default.
+ */
+class BinaryHeap {
+public:
+    explicit BinaryHeap(SearchTree &tree) : tree(tree) {}
+    bool empty() { return q.empty(); }
+    void push(int v) { q.insert(tree.node(v)); }
+    void decrease(int v) { q.decreaseKey(tree.node(v)); }
+    int pop() { return tree.indexOf(q.extractMin()); }
+
+private:
+    SearchTree &tree;
+    MutablePriorityQueue<SearchNode> q;
+};
+
+/**
+ * 4-ary heap storing (key, vertex) pairs inline, so comparisons never dereference the search nodes.
+ * The position of each queued vertex is kept in its node's queueIndex.
+ * @note Time Complexity: O(log V) for push, decrease and pop, with half the levels of a binary heap.
+ */
+class QuaternaryHeap {
+public:
+    explicit QuaternaryHeap(SearchTree &tree) : tree(tree) {}
+    bool empty() const { return heap.empty(); }
+    void push(int v) {
+        ROUTING_COUNT(pushes);
+        heap.push_back({tree.node(v)->key, v});
+        siftUp(heap.size() - 1);
+    }
+    void decrease(int v) {
+        ROUTING_COUNT(decreases);
+        unsigned i = tree.node(v)->queueIndex;
+        heap[i].key = tree.node(v)->key;
+        siftUp(i);
+    }
+    int pop() {
+        ROUTING_COUNT(pops);
+        int v = heap[0].v;
+        Entry last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) siftDown(last);
+        return v;
+    }
+
+private:
+    struct Entry {
+        double key;
+        int v;
+    };
+
+    SearchTree &tree;
+    std::vector<Entry> heap;
+
+    void place(unsigned i, const Entry &e) {
+        heap[i] = e;
+        tree.node(e.v)->queueIndex = i;
+    }
+    void siftUp(unsigned i) {
+        Entry e = heap[i];
+        while (i > 0 && e.key < heap[(i - 1) / 4].key) {
+            place(i, heap[(i - 1) / 4]);
+            i = (i - 1) / 4;
+        }
+        place(i, e);
+    }
+    // moves e down from the root
+    void siftDown(const Entry &e) {
+        unsigned i = 0;
+        const unsigned n = heap.size();
+        while (4 * i + 1 < n) {
+            unsigned first = 4 * i + 1, best = first;
+            for (unsigned c = first + 1; c < first + 4 && c < n; c++) {
+                if (heap[c].key < heap[best].key) best = c;
+            }
+            if (!(heap[best].key < e.key)) break;
+            place(i, heap[best]);
+            i = best;
+        }
+        place(i, e);
+    }
+};
+
+/**
+ * Radix heap: a monotone queue with one bucket per bit of difference from the last extracted key, so each entry
+ * moves down at most 64 times. Non-negative doubles compare like the integers of their bit patterns, which makes
+ * it exact for any non-negative weights (the integer minutes of Distances.csv included).
+ * Decreasing a key pushes a new entry; outdated entries are skipped when popped.
+ * It requires keys that never go below the last extracted one, which holds for Dijkstra.
+ * @note Time Complexity: O(1) for push and decrease, amortised O(64) for pop.
+ */
+class RadixHeap {
+public:
+    explicit RadixHeap(SearchTree &tree) : tree(tree) {}
+    bool empty() const { return live == 0; }
+    void push(int v) {
+        ROUTING_COUNT(pushes);
+        insert(v);
+        live++;
+    }
+    void decrease(int v) {
+        ROUTING_COUNT(decreases);
+        insert(v);
+    }
+    int pop() {
+        ROUTING_COUNT(pops);
+        while (true) {
+            if (buckets[0].empty()) refill();
+            Entry e = buckets[0].back();
+            buckets[0].pop_back();
+            if (e.key != keyOf(e.v)) continue; // outdated by a later decrease
+            live--;
+            return e.v;
+        }
+    }
+
+private:
+    struct Entry {
+        uint64_t key;
+        int v;
+    };
+
+    SearchTree &tree;
+    std::vector<Entry> buckets[65];
+    uint64_t last = 0;
+    unsigned live = 0; // queued vertices, outdated entries excluded
+
+    uint64_t keyOf(int v) { return std::bit_cast<uint64_t>(tree.node(v)->key); }
+    static int bucketOf(uint64_t key, uint64_t last) { return key == last ? 0 : 64 - std::countl_zero(key ^ last); }
+    void insert(int v) {
+        uint64_t key = keyOf(v);
+        buckets[bucketOf(key, last)].push_back({key, v});
+    }
+    // moves the entries of the first non-empty bucket to lower buckets, relative to their smallest key
+    void refill() {
+        int i = 1;
+        while (buckets[i].empty()) i++;
+        last = buckets[i][0].key;
+        for (auto &e : buckets[i]) {
+            if (e.key < last) last = e.key;
+        }
+        for (auto &e : buckets[i]) buckets[bucketOf(e.key, last)].push_back(e);
+        buckets[i].clear();
+    }
+};
+
+#if defined(ROUTING_QUEUE_QUATERNARY)
+using SearchQueue = QuaternaryHeap;
+#elif defined(ROUTING_QUEUE_RADIX)
+using SearchQueue = RadixHeap;
+#else
+using SearchQueue = BinaryHeap;
+#endif
+
+#endif //SEARCHQUEUE_H
@@ -0,0 +1,123 @@
+#ifndef SEARCHWORKSPACE_H
+#define SEARCHWORKSPACE_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "CsrGraph.h"
+
+class WalkingTableCache;
+
+/**
+ * Search state of one vertex, kept outside the graph so that the graph stays read-only.
+ */
+struct SearchNode {
+    double dist = INF;
+    double key = INF; // queue priority: the distance, plus the estimate of the remaining distance in A* searches
+    int parent = -1; // index of the previous vertex in the path, -1 for the source or unreached vertices
+    int queueIndex = 0; // required by MutablePriorityQueue
+
+    bool operator<(const SearchNode &node) const { return key < node.key; }
+};
+
+/**
+ * Distances and shortest-path tree of a single search, indexed by vertex index.
+ * Resetting only clears the vertices reached by the previous search.
+ */
+class SearchTree {
+public:
+    /**
+     * Clears the tree and makes room for a graph with a given number of vertices.
+     * @param numVertex The number of vertices of the graph.
+     * @note Time Complexity: O(number of vertices reached by the previous search).
+     */
+    void reset(int numVertex);
+    /**
+     * Gets the distance of a vertex.
+     * @param v The index of the vertex.
+     * @return The distance from the source, or `INF` if not reached.
+     */
+    double getDist(int v) const { return nodes[v].dist; }
+    /**
+     * Gets the previous vertex in the path to a vertex.
+     * @param v The index of the vertex.
+     * @return The index of the previous vertex, or `-1` if there is none.
+     */
+    int getParent(int v) const { return nodes[v].parent; }
+    /**
+     * Updates the distance and previous vertex of a vertex, using the distance as its queue priority.
+     * @param v The index of the vertex.
+     * @param dist The new distance.
+     * @param parent The index of the previous vertex, `-1` for the source.
+     */
+    void set(int v, double dist, int parent);
+    /**
+     * Overrides the queue priority of a reached vertex.
+     * @param v The index of the vertex.
+     * @param key The new priority.
+     */
+    void setKey(int v, double key) { nodes[v].key = key; }
+    /**
+     * Gets the search node of a vertex, as stored in the priority queue.
+     * @param v The index of the vertex.
+     * @return A pointer to the node.
+     */
+    SearchNode *node(int v) { return &nodes[v]; }
+    /**
+     * Gets the vertex index of a search node.
+     * @param node A pointer to a node of this tree.
+     * @return The index of the vertex.
+     */
+    int indexOf(const SearchNode *node) const { return node - nodes.data(); }
+
+    unsigned settled = 0; // vertices extracted from the queue by the search
+
+private:
+    std::vector<SearchNode> nodes;
+    std::vector<int> touched; // vertices whose node was changed since the last reset
+};
+
+/**
+ * Per-thread (or per-query) mutable state of the route searches: the search tree and the sets of avoided
+ * vertices and edges. Searches only read the CsrGraph, so several threads may query the same graph at once
+ * as long as each one uses its own workspace.
+ */
+class SearchWorkspace {
+public:
+    /**
+     * Sets the vertices and edges that the next searches must avoid.
+     * @param g Pointer to the graph that will be searched.
+     * @param avoid_nodes List of node IDs to avoid. Unknown IDs are ignored.
+     * @param avoid_edges List of edges (pairs of node IDs) to avoid, in every mode. Unknown edges are ignored.
+     * @note Time Complexity: O(V / 64) when the graph changes, O(number of avoided nodes and edges) otherwise.
+     */
+    void setAvoided(const CsrGraph *g, const std::vector<int> &avoid_nodes, const std::vector<std::pair<int, int>> &avoid_edges);
+    /**
+     * Checks if a vertex must be avoided.
+     * @param v The index of the vertex.
+     * @return `true` if the vertex is avoided, `false` otherwise.
+     */
+    bool isAvoided(int v) const { return avoidNode[v >> 6] >> (v & 63) & 1; }
+    /**
+     * Checks if an edge must be avoided.
+     * @param u The index of the origin vertex.
+     * @param v The index of the destination vertex.
+     * @return `true` if the edge is avoided, `false` otherwise.
+     */
+    bool isAvoided(int u, int v) const;
+
+    SearchTree tree; // tree of the current search
+    SearchTree backward; // tree grown from the destination by bidirectional searches
+    SearchTree layered; // walking and driving states of DriveWalkSearch
+    std::vector<int> labelParking; // parking node of each driving state of DriveWalkSearch
+    std::vector<char> pendingTarget; // targets of Dijkstra::oneToMany not settled yet, all 0 between searches
+    WalkingTableCache *walkingTables = nullptr; // optional cache of Dijkstra::bestPathDriveWalk, may be shared by several workspaces
+
+private:
+    std::vector<uint64_t> avoidNode; // bitset of avoided vertices
+    std::vector<uint64_t> avoidOut; // bitset of vertices with at least one avoided outgoing edge
+    std::vector<int> avoidedNodes;
+    std::vector<std::pair<int, int>> avoidedEdges; // pairs of vertex indexes
+};
+
+#endif //SEARCHWORKSPACE_H
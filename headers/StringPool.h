@@ -0,0 +1,156 @@
+/*
+ * StringPool.h
+ * Interned strings, used by Graph to store the names and codes of the locations once.
+ */
+
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+/**
+ * Append-only store of strings, packed one after the other in large blocks, each one after its length.
+ * A stored string is referred to by a Ref, one pointer wide, which stays valid until the pool is cleared or destroyed.
+ */
+class StringPool {
+public:
+    static constexpr size_t BLOCK_SIZE = 1 << 16; // bytes per block
+    using Ref = const char *; // start of a stored string, `nullptr` for the empty string
+
+    /**
+     * Constructs an empty StringPool.
+     */
+    StringPool();
+    StringPool(const StringPool &) = delete;
+    StringPool &operator=(const StringPool &) = delete;
+    /**
+     * Gets the copy of a text stored in the pool, adding it if it is not there yet.
+     * Only the strings added by intern are looked up.
+     * @param text The text to intern.
+     * @return The stored copy.
+     * @throws std::length_error if the text is 4 GiB or longer (see add).
+     * @note Time Complexity: O(|text|) on average.
+     */
+    Ref intern(std::string_view text);
+    /**
+     * Stores a copy of a text without looking for an equal string, for texts known to be distinct.
+     * @param text The text to store.
+     * @return The stored copy.
+     * @throws std::length_error if the text is 4 GiB or longer, since lengths are stored in 32 bits.
+     * @note Time Complexity: O(|text|).
+     */
+    Ref add(std::string_view text);
+    /**
+     * Gets the text of a stored string.
+     * @param ref The string.
+     * @return A view of the text.
+     */
+    static std::string_view view(Ref ref);
+    /**
+     * Removes every string, invalidating the views given so far.
+     */
+    void clear();
+    /**
+     * Gets the number of strings in the pool.
+     * @return The number of strings.
+     */
+    unsigned size() const { return count; }
+    /**
+     * Gets the memory used by the pool.
+     * @return The number of bytes of the blocks and of the hash table.
+     */
+    size_t bytes() const { return blockBytes + table.capacity() * sizeof(Ref); }
+
+private:
+    std::vector<std::unique_ptr<char[]>> blocks;
+    size_t blockBytes = 0; // bytes reserved by the blocks
+    char *next = nullptr; // free space of the block being filled
+    size_t freeBytes = 0;
+    std::vector<Ref> table; // interned strings, open addressing
+    unsigned count = 0, interned = 0;
+
+    char *allocate(size_t length);
+    void rehash(size_t capacity);
+};
+
+inline StringPool::StringPool() : table(16, nullptr) {}
+
+inline StringPool::Ref StringPool::intern(std::string_view text) {
+    if (text.empty()) return nullptr;
+    if ((interned + 1) * 10 > table.size() * 7) rehash(table.size() * 2);
+    size_t mask = table.size() - 1;
+    size_t i = std::hash<std::string_view>()(text) & mask;
+    for (; table[i] != nullptr; i = (i + 1) & mask) {
+        if (view(table[i]) == text) return table[i];
+    }
+    table[i] = add(text);
+    interned++;
+    return table[i];
+}
+
+inline StringPool::Ref StringPool::add(std::string_view text) {
+    if (text.empty()) return nullptr;
+    if (text.size() > UINT32_MAX) throw std::length_error("StringPool: string of 4 GiB or more");
+    const uint32_t length = text.size();
+    char *copy = allocate(sizeof(length) + length);
+    std::memcpy(copy, &length, sizeof(length));
+    std::memcpy(copy + sizeof(length), text.data(), length);
+    count++;
+    return copy;
+}
+
+inline std::string_view StringPool::view(Ref ref) {
+    if (ref == nullptr) return {};
+    uint32_t length;
+    std::memcpy(&length, ref, sizeof(length));
+    return {ref + sizeof(length), length};
+}
+
+inline void StringPool::clear() {
+    blocks.clear();
+    blockBytes = freeBytes = 0;
+    next = nullptr;
+    table.assign(16, nullptr);
+    count = interned = 0;
+}
+
+/*
+ * Reserves room for a string; long ones get a block of their own, so that the block being filled keeps its free bytes.
+ */
+inline char *StringPool::allocate(size_t length) {
+    if (length > BLOCK_SIZE / 4) {
+        blocks.push_back(std::make_unique<char[]>(length));
+        blockBytes += length;
+        return blocks.back().get();
+    }
+    if (length > freeBytes) {
+        blocks.push_back(std::make_unique<char[]>(BLOCK_SIZE));
+        blockBytes += BLOCK_SIZE;
+        next = blocks.back().get();
+        freeBytes = BLOCK_SIZE;
+    }
+    char *res = next;
+    next += length;
+    freeBytes -= length;
+    return res;
+}
+
+inline void StringPool::rehash(size_t capacity) {
+    std::vector<Ref> old(capacity, nullptr);
+    old.swap(table);
+    size_t mask = capacity - 1;
+    for (auto s : old) {
+        if (s == nullptr) continue;
+        size_t i = std::hash<std::string_view>()(view(s)) & mask;
+        while (table[i] != nullptr) i = (i + 1) & mask;
+        table[i] = s;
+    }
+}
+
+#endif //STRINGPOOL_H
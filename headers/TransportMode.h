@@ -0,0 +1,53 @@
+#ifndef TRANSPORTMODE_H
+#define TRANSPORTMODE_H
+
+#include <string>
+
+/**
+ * Transportation modes, as a bitmask so that combined modes (e.g. driving-walking) can be expressed.
+ * Edges always have exactly one mode.
+ */
+enum class TransportMode : unsigned char {
+    NONE = 0,
+    DRIVING = 1 << 0,
+    WALKING = 1 << 1,
+    DRIVING_WALKING = DRIVING | WALKING
+};
+
+inline TransportMode operator|(TransportMode a, TransportMode b) {
+    return static_cast<TransportMode>(static_cast<unsigned char>(a) | static_cast<unsigned char>(b));
+}
+
+inline TransportMode operator&(TransportMode a, TransportMode b) {
+    return static_cast<TransportMode>(static_cast<unsigned char>(a) & static_cast<unsigned char>(b));
+}
+
+/**
+ * Parses a transportation mode as written in the input files and menus.
+ * @param str The mode name ("driving", "walking" or "driving-walking").
+ * @param mode Reference to store the parsed mode.
+ * @return `true` if the name is valid, `false` otherwise.
+ */
+inline bool parseTransportMode(const std::string &str, TransportMode &mode) {
+    if (str == "driving") mode = TransportMode::DRIVING;
+    else if (str == "walking") mode = TransportMode::WALKING;
+    else if (str == "driving-walking") mode = TransportMode::DRIVING_WALKING;
+    else return false;
+    return true;
+}
+
+/**
+ * Gets the name of a transportation mode.
+ * @param mode The transportation mode.
+ * @return The name of the mode, as accepted by parseTransportMode.
+ */
+inline std::string toString(TransportMode mode) {
+    switch (mode) {
+        case TransportMode::DRIVING: return "driving";
+        case TransportMode::WALKING: return "walking";
+        case TransportMode::DRIVING_WALKING: return "driving-walking";
+        default: return "none";
+    }
+}
+
+#endif //TRANSPORTMODE_H
@@ -0,0 +1,132 @@
+#ifndef WALKINGTABLECACHE_H
+#define WALKINGTABLECACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "CsrGraph.h"
+#include "SearchWorkspace.h"
+
+/**
+ * Result of a full walking search from a destination: the walking time from every reachable parking node, enough
+ * for Dijkstra::bestPathDriveWalk to score parking nodes. The walking routes are not kept, as they would take
+ * O(V) per table; the routes of the parking nodes chosen are rebuilt by a search bounded by their walking times.
+ */
+struct WalkingTable {
+    std::vector<int> parking; // reachable parking nodes (vertex indexes), in index order
+    std::vector<double> dist; // walking time from each of them to the destination
+
+    /**
+     * Builds the table of a finished walking search.
+     * @param g Pointer to the graph.
+     * @param tree The tree of a walking search from the destination, without target nor bound.
+     * @note Time Complexity: O(V).
+     */
+    WalkingTable(const CsrGraph *g, const SearchTree &tree);
+    /**
+     * Gets the memory used by the table.
+     * @return The number of bytes.
+     */
+    size_t bytes() const;
+};
+
+/**
+ * Thread-safe LRU cache of walking tables, keyed by destination and set of avoided nodes and edges, so repeated
+ * driving-walking queries to the same destination skip the walking search. Entries are evicted, least recently
+ * used first, to keep the memory of the tables under a capacity.
+ * The tables belong to one graph: the cache is cleared when it is used with another graph, and must be cleared
+ * explicitly when a graph is replaced at the same address.
+ */
+class WalkingTableCache {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 64 << 20; // bytes
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t entries = 0;
+        size_t bytes = 0; // memory of the cached tables and keys
+        size_t capacity = 0;
+    };
+
+    /**
+     * Constructs an empty cache.
+     * @param capacity Maximum memory of the cached tables, in bytes; 0 disables the cache.
+     */
+    explicit WalkingTableCache(size_t capacity = DEFAULT_CAPACITY);
+    /**
+     * Looks up the table of a destination, counting a hit or a miss.
+     * @param g Pointer to the graph searched.
+     * @param destination Index of the destination.
+     * @param avoid_nodes List of node IDs avoided by the search (order and repetitions do not matter).
+     * @param avoid_edges List of edges avoided by the search.
+     * @return The table, or `nullptr` if it is not cached.
+     * @note Time Complexity: O(A log A), A being the number of avoided nodes and edges.
+     */
+    std::shared_ptr<const WalkingTable> find(const CsrGraph *g, int destination, const std::vector<int> &avoid_nodes, const std::vector<std::pair<int, int>> &avoid_edges);
+    /**
+     * Adds the table of a destination, evicting the least recently used tables if needed.
+     * Tables larger than the capacity are not cached.
+     * @param g Pointer to the graph searched.
+     * @param destination Index of the destination.
+     * @param avoid_nodes List of node IDs avoided by the search.
+     * @param avoid_edges List of edges avoided by the search.
+     * @param table The table.
+     * @note Time Complexity: O(A log A) plus the evicted tables.
+     */
+    void insert(const CsrGraph *g, int destination, const std::vector<int> &avoid_nodes, const std::vector<std::pair<int, int>> &avoid_edges, std::shared_ptr<const WalkingTable> table);
+    /**
+     * Removes every table, e.g. after the graph changed. The counters are kept.
+     */
+    void clear();
+    /**
+     * Gets the counters and memory use of the cache.
+     * @return The statistics.
+     */
+    Stats getStats() const;
+
+private:
+    // avoided nodes and edges as sorted vertex indexes, unknown IDs dropped, like SearchWorkspace::setAvoided
+    struct Key {
+        int destination;
+        std::vector<int> nodes;
+        std::vector<std::pair<int, int>> edges;
+        uint64_t hash;
+
+        bool operator==(const Key &key) const { return destination == key.destination && nodes == key.nodes && edges == key.edges; }
+    };
+    struct KeyHash {
+        size_t operator()(const Key &key) const { return key.hash; }
+    };
+    struct Entry {
+        Key key;
+        std::shared_ptr<const WalkingTable> table;
+        size_t bytes;
+    };
+
+    mutable std::mutex mutex;
+    std::list<Entry> entries; // most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+    const CsrGraph *graph = nullptr; // graph of the cached tables
+    int numVertex = 0;
+    size_t capacity;
+    Stats stats;
+
+    static Key makeKey(const CsrGraph *g, int destination, const std::vector<int> &avoid_nodes, const std::vector<std::pair<int, int>> &avoid_edges);
+    /**
+     * Clears the cache if it holds tables of another graph. Requires the lock.
+     */
+    void checkGraph(const CsrGraph *g);
+    /**
+     * Removes every table. Requires the lock.
+     */
+    void removeAll();
+};
+
+#endif //WALKINGTABLECACHE_H
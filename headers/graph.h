@@ -10,7 +10,12 @@
 #include <queue>
 #include <limits>
 #include <algorithm>
-#include "../headers/MutablePriorityQueue.h"
+#include <string_view>
+#include "../headers/CodeIndex.h"
+#include "../headers/IdIndex.h"
+#include "../headers/ObjectPool.h"
+#include "../headers/StringPool.h"
+#include "../headers/TransportMode.h"
 
 template <class T>
 class Edge;
@@ -19,28 +24,64 @@ class Edge;
 
 /************************* Vertex  **************************/
 
+/**
+ * Data of the vertices of a graph that searches do not touch, kept by the graph as one array per field,
+ * each vertex having a slot in every array. Names and codes are interned in a single string pool.
+ */
+template <class T>
+struct VertexMetadata {
+    StringPool strings; // names and codes
+    std::vector<StringPool::Ref> names, codes;
+    std::vector<char> parking;
+    std::vector<char> located; // true if latitude and longitude are known
+    std::vector<double> latitude, longitude;
+    std::vector<unsigned int> indegree; // used by topsort
+    std::vector<std::vector<Edge<T> *>> incoming; // incoming edges
+    size_t removedCodeBytes = 0; // bytes of the pool taken by the codes of removed vertices
+
+    /**
+     * Takes a slot for a new vertex, reusing the slot of a removed one if there is any.
+     * @param name The name of the location, in the string pool.
+     * @param code The code of the location, in the string pool.
+     * @param hasParking Bool that indicates if the location has parking.
+     * @return The slot of the vertex.
+     */
+    unsigned add(StringPool::Ref name, StringPool::Ref code, bool hasParking);
+    /**
+     * Frees the slot of a removed vertex. Its name and code stay in the pool until the graph is destroyed:
+     * the code is counted in removedCodeBytes, the name stays interned and is reused if it is added again.
+     * @param slot The slot of the vertex.
+     */
+    void remove(unsigned slot);
+    /**
+     * Gets the memory used by the arrays and the string pool, not counting the incoming edge lists.
+     * @return The number of bytes.
+     */
+    size_t bytes() const;
+
+private:
+    std::vector<unsigned> freeSlots;
+};
+
+/**
+ * Vertex of a graph, holding only its outgoing edges, its ID and its metadata slot (40 bytes on 64-bit targets);
+ * searches keep their state in a SearchTree and the other data of the vertex is in the VertexMetadata of its graph.
+ */
 template <class T>
 class Vertex {
 public:
     /**
      * Constructs a Vertex object.
-     * @param name The name of the location.
      * @param id The unique identifier of the location.
-     * @param code The code of the location.
-     * @param parking Bool that indicates if the location has parking or not.
-     */
-    Vertex(std::string name, int id, std::string code, bool parking);
-    /**
-     * Compares two vertices based on their distance.
-     * @param vertex The vertex to compare with.
-     * @return `true` if this vertex has a smaller distance, `false` otherwise.
+     * @param metadata The metadata of the vertices of the graph.
+     * @param slot The slot of the vertex in the metadata.
      */
-    bool operator<(Vertex<T> & vertex) const; // // required by MutablePriorityQueue
+    Vertex(int id, VertexMetadata<T> *metadata, unsigned slot);
     /**
     * Gets the name of the vertex.
-    * @return The name of the vertex.
+    * @return The name of the vertex, valid while the graph exists.
     */
-    [[nodiscard]] std::string getName() const;
+    [[nodiscard]] std::string_view getName() const;
     /**
      * Gets the ID of the vertex.
      * @return The ID of the vertex.
@@ -48,124 +89,99 @@ public:
     [[nodiscard]] int getID() const;
     /**
      * Gets the code of the vertex.
-     * @return The code of the vertex.
+     * @return The code of the vertex, valid while the graph exists.
      */
-    [[nodiscard]] std::string getCode() const;
+    [[nodiscard]] std::string_view getCode() const;
     /**
      * Checks if the vertex has parking or not.
      * @return `true` if it has parking, `false` otherwise.
      */
     [[nodiscard]] bool getParking() const;
+    /**
+     * Checks if the location of the vertex is known.
+     * @return `true` if the vertex has a latitude and longitude, `false` otherwise.
+     */
+    [[nodiscard]] bool hasCoordinates() const;
+    /**
+     * Gets the latitude of the vertex.
+     * @return The latitude in degrees, meaningful only if hasCoordinates().
+     */
+    [[nodiscard]] double getLatitude() const;
+    /**
+     * Gets the longitude of the vertex.
+     * @return The longitude in degrees, meaningful only if hasCoordinates().
+     */
+    [[nodiscard]] double getLongitude() const;
+    /**
+     * Sets the location of the vertex.
+     * @param latitude The latitude in degrees.
+     * @param longitude The longitude in degrees.
+     */
+    void setCoordinates(double latitude, double longitude);
     /**
     * Finds an edge to a given destination vertex.
     * @param dest The ID of the destination vertex.
+    * @param mode The transportation mode of the edge.
     * @return A pointer to the edge if found, `nullptr` otherwise.
     */
-    Edge<T> * findEdge(int dest, const std::string &mode);
+    Edge<T> * findEdge(int dest, TransportMode mode);
     /**
      * Gets the outgoing edges of the vertex.
      * @return A vector of pointers to the outgoing edges.
      */
     std::vector<Edge<T> *> getAdj() const;
-    /**
-     * Checks if the vertex has been visited.
-     * @return `true` if visited, `false` otherwise.
-     */
-    bool isVisited() const;
-    /**
-     * Checks if the vertex is being processed.
-     * @return `true` if processing, `false` otherwise.
-     */
-    bool isProcessing() const;
     /**
      * Gets the indegree of the vertex.
      * @return The indegree of the vertex.
      */
     unsigned int getIndegree() const;
-    /**
-     * Gets the distance of the vertex.
-     * @return The distance of the vertex.
-     */
-    double getDist() const;
-    /**
-     * Gets the path edge leading to the vertex.
-     * @return A pointer to the path edge.
-     */
-    Edge<T> *getPath() const;
     /**
      * Gets the incoming edges of the vertex.
      * @return A vector of pointers to the incoming edges.
      */
     std::vector<Edge<T> *> getIncoming() const;
-    /**
-     * Sets the visited status of the vertex.
-     * @param visited The new visited status.
-     */
-    void setVisited(bool visited);
-    /**
-     * Sets the processing status of the vertex.
-     * @param processing The new processing status.
-     */
-    void setProcessing(bool processing);
     /**
      * Sets the indegree of the vertex.
      * @param indegree The new indegree value.
      */
     void setIndegree(unsigned int indegree);
-    /**
-     * Sets the distance of the vertex.
-     * @param dist The new distance value.
-     */
-    void setDist(double dist);
-    /**
-     * Sets the path edge leading to this vertex.
-     * @param path A pointer to the new path edge.
-     */
-    void setPath(Edge<T> *path);
 
     /**
      * Adds an outgoing edge to the vertex.
      * @param d The destination vertex.
      * @param distance The weight of the edge.
-     * @param label The label of the edge.
+     * @param mode The transportation mode of the edge.
+     * @param pool The pool that holds the edges of the graph.
      * @return A pointer to the newly created edge.
      */
-    Edge<T> *addEdge(Vertex<T> *d, double distance, std::string label);
+    Edge<T> *addEdge(Vertex<T> *d, double distance, TransportMode mode, ObjectPool<Edge<T>> &pool);
     /**
      * Removes an outgoing edge to a given destination vertex.
      * @param in The ID of the destination vertex.
+     * @param pool The pool that holds the edges of the graph.
      * @return `true` if the edge was removed, `false` otherwise.
      */
-    bool removeEdge(T in);
+    bool removeEdge(T in, ObjectPool<Edge<T>> &pool);
     /**
     * Removes all outgoing edges of the vertex.
+    * @param pool The pool that holds the edges of the graph.
     */
-    void removeOutgoingEdges();
+    void removeOutgoingEdges(ObjectPool<Edge<T>> &pool);
 
-    friend class MutablePriorityQueue<Vertex>;
 protected:
     std::vector<Edge<T> *> adj;  // outgoing edges
-    std::string name; // place name
+    VertexMetadata<T> *metadata; // name, code, parking, coordinates, indegree and incoming edges
     int id; // place id
-    std::string code; // place code
-    bool hasParking; // place parking
-
-    // auxiliary fields
-    bool visited = false; // used by DFS, BFS, Prim ...
-    bool processing = false; // used by isDAG (in addition to the visited attribute)
-    unsigned int indegree; // used by topsort
-    double dist = 0;
-    Edge<T> *path = nullptr;
-
-    std::vector<Edge<T> *> incoming; // incoming edges
-
-    int queueIndex = 0; 		// required by MutablePriorityQueue and UFDS
+    unsigned slot; // position in the arrays of metadata
 
     /**
      * Deletes an edge and removes it from the incoming list of the destination vertex.
      * @param edge The edge to delete.
+     * @param pool The pool that holds the edge.
      */
-    void deleteEdge(Edge<T> *edge);
+    void deleteEdge(Edge<T> *edge, ObjectPool<Edge<T>> &pool);
+
+    template <class> friend class Graph;
 };
 
 /********************** Edge  ****************************/
@@ -178,9 +194,9 @@ public:
      * @param orig The origin vertex.
      * @param dest The destination vertex.
      * @param distance The weight of the edge.
-     * @param label The label of the edge.
+     * @param mode The transportation mode of the edge.
      */
-    Edge(Vertex<T> *orig, Vertex<T> *dest, double distance, std::string label);
+    Edge(Vertex<T> *orig, Vertex<T> *dest, double distance, TransportMode mode);
     /**
      * Gets the destination vertex of the edge.
      * @return A pointer to the destination vertex.
@@ -212,10 +228,10 @@ public:
      */
     Edge<T> *getReverse() const;
     /**
-      * Gets the label of the edge.
-      * @return The label of the edge.
+      * Gets the transportation mode of the edge.
+      * @return The transportation mode of the edge.
       */
-    std::string getLabel() const;
+    TransportMode getMode() const;
     /**
      * Sets whether the edge should be avoided.
      * @param avoid The new avoid status.
@@ -234,7 +250,7 @@ public:
 protected:
     Vertex<T> * dest; // destination vertex
     double weight; // edge weight, can also be used for capacity
-    std::string label;
+    TransportMode mode; // driving or walking
 
     // auxiliary fields
     bool selected = false;
@@ -248,45 +264,76 @@ protected:
 
 /********************** Graph  ****************************/
 
+/**
+ * Memory used by a graph, in bytes, split by what it holds.
+ */
+struct GraphMemory {
+    size_t vertices = 0, edges = 0; // number of vertices and of edges (two per bidirectional segment)
+    size_t vertexBytes = 0; // vertex pool
+    size_t edgeBytes = 0; // edge pool
+    size_t adjacencyBytes = 0; // outgoing and incoming edge lists
+    size_t metadataBytes = 0; // vertex metadata arrays
+    size_t stringBytes = 0; // string pool of the names and codes
+    size_t removedStringBytes = 0; // part of stringBytes taken by the codes of removed vertices, never reclaimed
+    size_t indexBytes = 0; // vertex set, ID index and code index
+
+    size_t total() const { return vertexBytes + edgeBytes + adjacencyBytes + metadataBytes + stringBytes + indexBytes; }
+};
+
 template <class T>
 class Graph {
 public:
+    Graph() = default;
+    Graph(const Graph &) = delete;
+    Graph &operator=(const Graph &) = delete;
     /**
-     * Destructor for the Graph class.
+     * Destructor for the Graph class, which releases every vertex and edge at once.
+     * @note Time Complexity: O(V), the edges have no destructor to run.
      */
     ~Graph();
     /**
      * Finds a vertex with a given content.
-     * @param in The content of the vertex to find.
+     * @param in The code (string) or ID (integer) of the vertex to find.
      * @return A pointer to the vertex if found, `nullptr` otherwise.
+     * @note Time Complexity: O(1), using the code and ID indexes.
      */
-    Vertex<T> *findVertex(const std::string &in) const;
+    Vertex<T> *findVertex(std::string_view in) const;
     Vertex<T> *findVertex(const int &in) const;
+    /**
+     * Finds the position in the vertex set of a vertex with a given content.
+     * @param in The code (string) or ID (integer) of the vertex to find.
+     * @return The position of the vertex if found, `-1` otherwise.
+     * @note Time Complexity: O(1), using the code and ID indexes.
+     */
+    int findVertexIdx(std::string_view in) const;
+    int findVertexIdx(const T &in) const;
     /**
      * Adds a vertex with a given content to the graph.
      * @param name The name of the location.
      * @param id The unique identifier of the location.
      * @param code The code of the location.
      * @param hasParking Bool that indicates if the location has parking.
-     * @return `true` if the vertex was added successfully, `false` otherwise.
+     * @return `true` if the vertex was added successfully, `false` if a vertex with the same ID or code already exists.
      */
-    bool addVertex(const std::string& name, const int& id, const std::string &code, const bool &hasParking);
+    bool addVertex(std::string_view name, const int& id, std::string_view code, const bool &hasParking);
     /**
      * Removes a vertex with a given content from the graph.
      * @param in The content of the vertex to find.
      * @return `true` if the vertex was removed successfully, `false` otherwise.
+     * @note Time Complexity: O(V + E), the indexes of the vertices after it are shifted.
+     * The name and code of the vertex are not reclaimed from the string pool (see GraphMemory::removedStringBytes).
      */
     bool removeVertex(const T &in);
 
     /**
      * Adds a bidirectional edge to the graph.
-     * @param source The content of the source vertex.
-     * @param dest The content of the destination vertex.
+     * @param source The code of the source vertex.
+     * @param dest The code of the destination vertex.
      * @param distance The weight of the edge.
-     * @param label The label of the edge.
+     * @param mode The transportation mode of the edge.
      * @return `true` if the edge was added successfully, `false` otherwise.
      */
-    bool addBidirectionalEdge(const std::string &source, const std::string &dest, double distance, std::string label);
+    bool addBidirectionalEdge(std::string_view source, std::string_view dest, double distance, TransportMode mode);
     /**
      * Gets the number of vertices in the graph.
      * @return The number of vertices.
@@ -297,47 +344,85 @@ public:
      * @return A vector of pointers to the vertices.
      */
     std::vector<Vertex<T> *> getVertexSet() const;
+    /**
+     * Measures the memory used by the graph.
+     * @return The number of vertices and edges and the bytes they take.
+     * @note Time Complexity: O(V), plus the slots of the code index.
+     */
+    GraphMemory getMemoryUsage() const;
 
 protected:
     std::vector<Vertex<T> *> vertexSet;    // vertex set
+    // the vertices and edges, laid out in the order they were added
+    VertexMetadata<T> metadata;
+    ObjectPool<Vertex<T>> vertexPool;
+    ObjectPool<Edge<T>> edgePool;
 
-    double ** distMatrix = nullptr;   // dist matrix for Floyd-Warshall
-    int **pathMatrix = nullptr;   // path matrix for Floyd-Warshall
+    IdIndex idIndex; // vertex ID -> position in vertexSet
+    CodeIndex codeIndex; // vertex code -> position in vertexSet
 
     /**
-     * Finds the index of the vertex with a given content.
-     * @param in The content of the vertex to find.
-     * @return The index of the vertex if found, `-1` otherwise.
+     * Updates the ID and code indexes of every vertex from a given position onwards.
+     * @param from The first position in vertexSet to update.
      */
-    int findVertexIdx(const T &in) const;
+    void reindexFrom(unsigned from);
 };
 
-/**
- * Deletes a matrix.
- * @param m The matrix to delete.
- * @param n The number of rows in the matrix.
- */
-void deleteMatrix(int **m, int n);
-void deleteMatrix(double **m, int n);
-
 
 /************************* Vertex  **************************/
 
 
+template <class T>
+unsigned VertexMetadata<T>::add(StringPool::Ref name, StringPool::Ref code, bool hasParking) {
+    if (!freeSlots.empty()) {
+        unsigned slot = freeSlots.back();
+        freeSlots.pop_back();
+        names[slot] = name;
+        codes[slot] = code;
+        parking[slot] = hasParking;
+        located[slot] = false;
+        latitude[slot] = longitude[slot] = 0;
+        indegree[slot] = 0;
+        return slot;
+    }
+    names.push_back(name);
+    codes.push_back(code);
+    parking.push_back(hasParking);
+    located.push_back(false);
+    latitude.push_back(0);
+    longitude.push_back(0);
+    indegree.push_back(0);
+    incoming.emplace_back();
+    return names.size() - 1;
+}
+
+template <class T>
+void VertexMetadata<T>::remove(unsigned slot) {
+    std::vector<Edge<T> *>().swap(incoming[slot]);
+    removedCodeBytes += sizeof(uint32_t) + StringPool::view(codes[slot]).size();
+    freeSlots.push_back(slot);
+}
+
+template <class T>
+size_t VertexMetadata<T>::bytes() const {
+    return (names.capacity() + codes.capacity()) * sizeof(StringPool::Ref) + parking.capacity() + located.capacity()
+        + (latitude.capacity() + longitude.capacity()) * sizeof(double) + indegree.capacity() * sizeof(unsigned int)
+        + incoming.capacity() * sizeof(std::vector<Edge<T> *>) + freeSlots.capacity() * sizeof(unsigned) + strings.bytes();
+}
+
 template<class T>
-Vertex<T>::Vertex(std::string name, int id,
-    std::string code, bool parking)
-    : name(name), id(id), code(code), hasParking(parking) {}
+Vertex<T>::Vertex(int id, VertexMetadata<T> *metadata, unsigned slot)
+    : metadata(metadata), id(id), slot(slot) {}
 
 /*
  * Auxiliary function to add an outgoing edge to a vertex (this),
  * with a given destination vertex (d) and edge weight (w).
  */
 template <class T>
-Edge<T> * Vertex<T>::addEdge(Vertex<T> *d, double distance, std::string label) {
-    auto newEdge = new Edge<T>(this, d, distance, label);
+Edge<T> * Vertex<T>::addEdge(Vertex<T> *d, double distance, TransportMode mode, ObjectPool<Edge<T>> &pool) {
+    auto newEdge = pool.create(this, d, distance, mode);
     adj.push_back(newEdge);
-    d->incoming.push_back(newEdge);
+    d->metadata->incoming[d->slot].push_back(newEdge);
     return newEdge;
 }
 
@@ -347,7 +432,7 @@ Edge<T> * Vertex<T>::addEdge(Vertex<T> *d, double distance, std::string label) {
  * Returns true if successful, and false if such edge does not exist.
  */
 template <class T>
-bool Vertex<T>::removeEdge(T in) {
+bool Vertex<T>::removeEdge(T in, ObjectPool<Edge<T>> &pool) {
     bool removedEdge = false;
     auto it = adj.begin();
     while (it != adj.end()) {
@@ -355,7 +440,7 @@ bool Vertex<T>::removeEdge(T in) {
         Vertex<T> *dest = edge->getDest();
         if (dest->getID() == in) {
             it = adj.erase(it);
-            deleteEdge(edge);
+            deleteEdge(edge, pool);
             removedEdge = true; // allows for multiple edges to connect the same pair of vertices (multigraph)
         }
         else {
@@ -369,28 +454,23 @@ bool Vertex<T>::removeEdge(T in) {
  * Auxiliary function to remove an outgoing edge of a vertex.
  */
 template <class T>
-void Vertex<T>::removeOutgoingEdges() {
+void Vertex<T>::removeOutgoingEdges(ObjectPool<Edge<T>> &pool) {
     auto it = adj.begin();
     while (it != adj.end()) {
         Edge<T> *edge = *it;
         it = adj.erase(it);
-        deleteEdge(edge);
+        deleteEdge(edge, pool);
     }
 }
 
-template <class T>
-bool Vertex<T>::operator<(Vertex<T> & vertex) const {
-    return this->dist < vertex.dist;
-}
-
 template<class T>
-std::string Vertex<T>::getName() const {
-    return this->name;
+std::string_view Vertex<T>::getName() const {
+    return StringPool::view(this->metadata->names[slot]);
 }
 
 template<class T>
-std::string Vertex<T>::getCode() const {
-    return this->code;
+std::string_view Vertex<T>::getCode() const {
+    return StringPool::view(this->metadata->codes[slot]);
 }
 
 template<class T>
@@ -400,99 +480,82 @@ int Vertex<T>::getID() const {
 
 template<class T>
 bool Vertex<T>::getParking() const {
-    return this->hasParking;
+    return this->metadata->parking[slot];
 }
 
 template <class T>
-Edge<T> * Vertex<T>::findEdge(const int dest, const std::string &mode) {
-    for (auto e : this->adj) {
-        if (e->getDest()->getID() == dest && e->getLabel()== mode) {
-            return e;
-        }
-    }
-    return nullptr;
+bool Vertex<T>::hasCoordinates() const {
+    return this->metadata->located[slot];
 }
 
 template <class T>
-std::vector<Edge<T>*> Vertex<T>::getAdj() const {
-    return this->adj;
+double Vertex<T>::getLatitude() const {
+    return this->metadata->latitude[slot];
 }
 
 template <class T>
-bool Vertex<T>::isVisited() const {
-    return this->visited;
+double Vertex<T>::getLongitude() const {
+    return this->metadata->longitude[slot];
 }
 
 template <class T>
-bool Vertex<T>::isProcessing() const {
-    return this->processing;
+void Vertex<T>::setCoordinates(const double latitude, const double longitude) {
+    this->metadata->latitude[slot] = latitude;
+    this->metadata->longitude[slot] = longitude;
+    this->metadata->located[slot] = true;
 }
 
 template <class T>
-unsigned int Vertex<T>::getIndegree() const {
-    return this->indegree;
+Edge<T> * Vertex<T>::findEdge(const int dest, const TransportMode mode) {
+    for (auto e : this->adj) {
+        if (e->getDest()->getID() == dest && e->getMode() == mode) {
+            return e;
+        }
+    }
+    return nullptr;
 }
 
 template <class T>
-double Vertex<T>::getDist() const {
-    return this->dist;
+std::vector<Edge<T>*> Vertex<T>::getAdj() const {
+    return this->adj;
 }
 
 template <class T>
-Edge<T> *Vertex<T>::getPath() const {
-    return this->path;
+unsigned int Vertex<T>::getIndegree() const {
+    return this->metadata->indegree[slot];
 }
 
 template <class T>
 std::vector<Edge<T> *> Vertex<T>::getIncoming() const {
-    return this->incoming;
-}
-
-template <class T>
-void Vertex<T>::setVisited(bool visited) {
-    this->visited = visited;
-}
-
-template <class T>
-void Vertex<T>::setProcessing(bool processing) {
-    this->processing = processing;
+    return this->metadata->incoming[slot];
 }
 
 template <class T>
 void Vertex<T>::setIndegree(unsigned int indegree) {
-    this->indegree = indegree;
-}
-
-template <class T>
-void Vertex<T>::setDist(double dist) {
-    this->dist = dist;
-}
-
-template <class T>
-void Vertex<T>::setPath(Edge<T> *path) {
-    this->path = path;
+    this->metadata->indegree[slot] = indegree;
 }
 
 template <class T>
-void Vertex<T>::deleteEdge(Edge<T> *edge) {
+void Vertex<T>::deleteEdge(Edge<T> *edge, ObjectPool<Edge<T>> &pool) {
     Vertex<T> *dest = edge->getDest();
     // Remove the corresponding edge from the incoming list
-    auto it = dest->incoming.begin();
-    while (it != dest->incoming.end()) {
+    auto &incoming = dest->metadata->incoming[dest->slot];
+    auto it = incoming.begin();
+    while (it != incoming.end()) {
         if ((*it)->getOrig()->getID() == id) {
-            it = dest->incoming.erase(it);
+            it = incoming.erase(it);
         }
         else {
             it++;
         }
     }
-    delete edge;
+    pool.destroy(edge);
 }
 
 /********************** Edge  ****************************/
 
 template <class T>
-Edge<T>::Edge(Vertex<T> *orig, Vertex<T> *dest, double distance, std::string label): orig(orig), dest(dest), weight(distance), label(label) {}
+Edge<T>::Edge(Vertex<T> *orig, Vertex<T> *dest, double distance, TransportMode mode): orig(orig), dest(dest), weight(distance), mode(mode) {}
 
 template <class T>
 Vertex<T> * Edge<T>::getDest() const {
@@ -515,8 +578,8 @@ Edge<T> *Edge<T>::getReverse() const {
 }
 
 template <class T>
-std::string Edge<T>::getLabel() const {
-    return this->label;
+TransportMode Edge<T>::getMode() const {
+    return this->mode;
 }
 
 template <class T>
@@ -562,42 +625,52 @@ std::vector<Vertex<T> *> Graph<T>::getVertexSet() const {
  * Auxiliary function to find a vertex with a given content.
  */
 template <class T>
-Vertex<T> * Graph<T>::findVertex(const std::string &in) const {
-    for (auto v : vertexSet) {
-        if (v->getCode() == in) {
-            return v;
-        }
-    }
-    return nullptr;
+Vertex<T> * Graph<T>::findVertex(std::string_view in) const {
+    int idx = codeIndex.find(in);
+    return idx == -1 ? nullptr : vertexSet[idx];
 }
 
 template <class T>
 Vertex<T> * Graph<T>::findVertex(const int &in) const {
-    for (auto v : vertexSet) {
-        if (v->getID() == in) {
-            return v;
-        }
-    }
-    return nullptr;
+    int idx = findVertexIdx(in);
+    return idx == -1 ? nullptr : vertexSet[idx];
+}
+
+template <class T>
+int Graph<T>::findVertexIdx(std::string_view in) const {
+    return codeIndex.find(in);
+}
+
+template <class T>
+int Graph<T>::findVertexIdx(const T &in) const {
+    return idIndex.find(in);
 }
 
 /*
- * Finds the index of the vertex with a given content.
+ * Re-points the indexes at the vertices that moved after an erase from vertexSet.
  */
 template <class T>
-int Graph<T>::findVertexIdx(const T &in) const {
-    for (unsigned i = 0; i < vertexSet.size(); i++)
-        if (vertexSet[i]->getID() == in)
-            return i;
-    return -1;
+void Graph<T>::reindexFrom(unsigned from) {
+    for (unsigned i = from; i < vertexSet.size(); i++) {
+        idIndex.update(vertexSet[i]->getID(), i);
+        codeIndex.update(vertexSet[i]->getCode(), i);
+    }
 }
+
 /*
  *  Adds a vertex with a given content to a graph (this).
  *  Returns true if successful, and false if a vertex with that content already exists.
  */
 template<class T>
-bool Graph<T>::addVertex(const std::string &name, const int &id, const std::string &code, const bool &hasParking) {
-    Vertex<T> *vertex = new Vertex<T>(name, id, code, hasParking);
+bool Graph<T>::addVertex(std::string_view name, const int &id, std::string_view code, const bool &hasParking) {
+    if (findVertexIdx(id) != -1 || findVertexIdx(code) != -1) return false;
+    // codes are unique, so only the names are looked up in the pool
+    StringPool::Ref storedCode = metadata.strings.add(code);
+    codeIndex.insert(StringPool::view(storedCode), vertexSet.size());
+    idIndex.insert(id, vertexSet.size());
+
+    unsigned slot = metadata.add(metadata.strings.intern(name), storedCode, hasParking);
+    Vertex<T> *vertex = vertexPool.create(id, &metadata, slot);
     vertexSet.push_back(vertex);
     return true;
 }
@@ -610,19 +683,21 @@ bool Graph<T>::addVertex(const std::string &name, const int &id, const std::stri
  */
 template <class T>
 bool Graph<T>::removeVertex(const T &in) {
-    for (auto it = vertexSet.begin(); it != vertexSet.end(); it++) {
-        if ((*it)->getID() == in) {
-            auto v = *it;
-            v->removeOutgoingEdges();
-            for (auto u : vertexSet) {
-                u->removeEdge(v->getID());
-            }
-            vertexSet.erase(it);
-            delete v;
-            return true;
-        }
+    int idx = findVertexIdx(in);
+    if (idx == -1) return false;
+
+    auto v = vertexSet[idx];
+    v->removeOutgoingEdges(edgePool);
+    for (auto u : vertexSet) {
+        u->removeEdge(v->getID(), edgePool);
     }
-    return false;
+    idIndex.erase(v->getID());
+    codeIndex.erase(v->getCode());
+    vertexSet.erase(vertexSet.begin() + idx);
+    reindexFrom(idx);
+    metadata.remove(v->slot);
+    vertexPool.destroy(v);
+    return true;
 }
 
 /*
@@ -631,39 +706,38 @@ bool Graph<T>::removeVertex(const T &in) {
  * Returns true if successful, and false if such edge does not exist.
  */
 template <class T>
-bool Graph<T>::addBidirectionalEdge(const std::string &source, const std::string &dest, double distance, std::string label) {
+bool Graph<T>::addBidirectionalEdge(std::string_view source, std::string_view dest, double distance, TransportMode mode) {
     auto v1 = findVertex(source);
     auto v2 = findVertex(dest);
     if (v1 == nullptr || v2 == nullptr) return false;
-    auto e1 = v1->addEdge(v2, distance, label);
-    auto e2 = v2->addEdge(v1, distance, label);
+    auto e1 = v1->addEdge(v2, distance, mode, edgePool);
+    auto e2 = v2->addEdge(v1, distance, mode, edgePool);
     e1->setReverse(e2);
     e2->setReverse(e1);
     return true;
 }
 
-inline void deleteMatrix(int **m, int n) {
-    if (m != nullptr) {
-        for (int i = 0; i < n; i++)
-            if (m[i] != nullptr)
-                delete [] m[i];
-        delete [] m;
-    }
-}
-
-inline void deleteMatrix(double **m, int n) {
-    if (m != nullptr) {
-        for (int i = 0; i < n; i++)
-            if (m[i] != nullptr)
-                delete [] m[i];
-        delete [] m;
-    }
+template <class T>
+GraphMemory Graph<T>::getMemoryUsage() const {
+    GraphMemory memory;
+    memory.vertices = vertexPool.size();
+    memory.edges = edgePool.size();
+    memory.vertexBytes = vertexPool.bytes();
+    memory.edgeBytes = edgePool.bytes();
+    for (auto v : vertexSet) memory.adjacencyBytes += v->adj.capacity() * sizeof(Edge<T> *);
+    for (auto &incoming : metadata.incoming) memory.adjacencyBytes += incoming.capacity() * sizeof(Edge<T> *);
+    memory.metadataBytes = metadata.bytes() - metadata.strings.bytes();
+    memory.stringBytes = metadata.strings.bytes();
+    memory.removedStringBytes = metadata.removedCodeBytes;
+    memory.indexBytes = vertexSet.capacity() * sizeof(Vertex<T> *) + idIndex.bytes() + codeIndex.bytes();
+    return memory;
 }
 
 template <class T>
 Graph<T>::~Graph() {
-    deleteMatrix(distMatrix, vertexSet.size());
-    deleteMatrix(pathMatrix, vertexSet.size());
+    vertexSet.clear();
+    edgePool.clear();
+    vertexPool.clear();
 }
 
 #endif /* DA_TP_CLASSES_GRAPH */
\ No newline at end of file
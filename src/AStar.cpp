@@ -0,0 +1,157 @@
+#include "../headers/AStar.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+static constexpr double EARTH_RADIUS_KM = 6371.0088;
+
+
+AStar::AStar() {}
+
+
+AStar::AStar(const CsrGraph *g, const unsigned landmarks) : g(g) {
+    for (int m = 0; m < CsrGraph::NUM_MODES; m++) {
+        if (g->getNumEdges(m) == 0) continue;
+        if (g->hasCoordinates()) {
+            costPerKm[m] = lowestCostPerKm(m);
+            if (costPerKm[m] > 0) {
+                bound[m] = Bound::GEOGRAPHIC;
+                continue;
+            }
+        }
+        if (landmarks > 0) {
+            selectLandmarks(m, landmarks);
+            bound[m] = Bound::LANDMARKS;
+        }
+    }
+}
+
+
+double AStar::greatCircle(const int u, const int v) const {
+    const double rad = M_PI / 180;
+    double lat1 = g->getLatitude(u) * rad, lat2 = g->getLatitude(v) * rad;
+    double dLat = lat2 - lat1, dLon = (g->getLongitude(v) - g->getLongitude(u)) * rad;
+    double a = sin(dLat / 2) * sin(dLat / 2) + cos(lat1) * cos(lat2) * sin(dLon / 2) * sin(dLon / 2);
+    return 2 * EARTH_RADIUS_KM * asin(min(1.0, sqrt(a)));
+}
+
+
+double AStar::lowestCostPerKm(const int mode) const {
+    double lowest = INF;
+    for (int u = 0; u < g->getNumVertex(); u++) {
+        for (unsigned e = g->edgeBegin(mode, u); e < g->edgeEnd(mode, u); e++) {
+            double km = greatCircle(u, g->getTarget(mode, e));
+            if (km == 0) continue;
+            lowest = min(lowest, max(0.0, g->getWeight(mode, e)) / km);
+        }
+    }
+    if (lowest == INF) return 0;
+    // keeps the bound below the true distance despite rounding in the haversine formula
+    return lowest * (1 - 1e-9);
+}
+
+
+void AStar::selectLandmarks(const int mode, const unsigned count) {
+    const int n = g->getNumVertex();
+    SearchWorkspace ws;
+    ws.setAvoided(g, {}, {});
+
+    // the first landmark is the farthest vertex from an arbitrary one with edges
+    int next = 0;
+    while (next < n && g->edgeBegin(mode, next) == g->edgeEnd(mode, next)) next++;
+    if (next == n) return;
+    dijkstra.dijkstra(g, ws, ws.tree, next, mode);
+    for (int v = 0; v < n; v++) {
+        if (ws.tree.getDist(v) != INF && ws.tree.getDist(v) > ws.tree.getDist(next)) next = v;
+    }
+
+    vector<vector<double>> dist;
+    vector<double> closest(n, INF); // distance to the nearest landmark picked so far
+    while (dist.size() < count) {
+        dijkstra.dijkstra(g, ws, ws.tree, next, mode);
+        dist.emplace_back(n);
+        for (int v = 0; v < n; v++) {
+            dist.back()[v] = ws.tree.getDist(v);
+            closest[v] = min(closest[v], ws.tree.getDist(v));
+        }
+
+        next = -1;
+        for (int v = 0; v < n; v++) {
+            if (g->edgeBegin(mode, v) == g->edgeEnd(mode, v)) continue;
+            if (next == -1 || closest[v] > closest[next]) next = v;
+        }
+        if (next == -1 || closest[next] == 0) break;
+    }
+
+    landmarks[mode] = dist.size();
+    landmarkDist[mode].resize((size_t) n * landmarks[mode]);
+    for (int v = 0; v < n; v++) {
+        for (unsigned i = 0; i < landmarks[mode]; i++) {
+            landmarkDist[mode][(size_t) v * landmarks[mode] + i] = dist[i][v];
+        }
+    }
+}
+
+
+double AStar::lowerBound(const int mode, const int v, const int t) const {
+    switch (bound[mode]) {
+        case Bound::GEOGRAPHIC:
+            return greatCircle(v, t) * costPerKm[mode];
+        case Bound::LANDMARKS: {
+            const double *dv = &landmarkDist[mode][(size_t) v * landmarks[mode]];
+            const double *dt = &landmarkDist[mode][(size_t) t * landmarks[mode]];
+            double res = 0;
+            for (unsigned i = 0; i < landmarks[mode]; i++) {
+                if (dt[i] == INF && dv[i] == INF) continue;
+                // edges are bidirectional, so a landmark reaching only one of them proves they are disconnected
+                if (dt[i] == INF || dv[i] == INF) return INF;
+                res = max(res, fabs(dt[i] - dv[i]));
+            }
+            return res;
+        }
+        default:
+            return 0;
+    }
+}
+
+
+Path AStar::bestPath(SearchWorkspace &ws, const int &start, const int &end, const TransportMode transportation_mode,
+                    const vector<int> &avoid_nodes, const vector<pair<int,int>> &avoid_edges) const {
+    if (g == nullptr) return {{}, INF};
+    int s = g->findVertexIdx(start), t = g->findVertexIdx(end);
+    int mode = CsrGraph::modeIndex(transportation_mode);
+    if (s == -1 || t == -1 || mode == -1) return {{}, INF};
+
+    ws.setAvoided(g, avoid_nodes, avoid_edges);
+    SearchTree &tree = ws.tree;
+    tree.reset(g->getNumVertex());
+    tree.set(s, 0, -1);
+    tree.setKey(s, lowerBound(mode, s, t));
+    if (tree.node(s)->key == INF) return {{}, INF};
+
+    MutablePriorityQueue<SearchNode> q;
+    q.insert(tree.node(s));
+    while (!q.empty()) {
+        int u = tree.indexOf(q.extractMin());
+        tree.settled++;
+        if (u == t) break;
+        for (unsigned e = g->edgeBegin(mode, u); e < g->edgeEnd(mode, u); e++) {
+            int v = g->getTarget(mode, e);
+            if (ws.isAvoided(v) || ws.isAvoided(u, v)) continue;
+            if (!dijkstra.relax(tree, u, v, g->getWeight(mode, e))) continue;
+
+            double h = lowerBound(mode, v, t);
+            if (h == INF) continue;
+            tree.setKey(v, tree.getDist(v) + h);
+            // a consistent bound never improves a settled node, but reinserting keeps the search exact if it did
+            if (tree.node(v)->queueIndex == 0) {
+                q.insert(tree.node(v));
+            } else {
+                q.decreaseKey(tree.node(v));
+            }
+        }
+    }
+    return {dijkstra.reconstructPath(g, tree, t), tree.getDist(t)};
+}
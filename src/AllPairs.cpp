@@ -0,0 +1,69 @@
+#include "../headers/AllPairs.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+using namespace std;
+
+
+AllPairs::AllPairs() {}
+
+
+bool AllPairs::build(const CsrGraph *g, const int mode, unsigned threads, const int maxVertices, std::string &error) {
+    *this = AllPairs();
+    const int numVertex = g->getNumVertex();
+    if (numVertex > maxVertices) {
+        error = "the graph has " + to_string(numVertex) + " vertices, the all-pairs tables are limited to " + to_string(maxVertices)
+                + " (they would take " + to_string(12 * (size_t) numVertex * numVertex >> 20) + " MiB)";
+        return false;
+    }
+    n = numVertex;
+    dist.resize(n * n);
+    pred.resize(n * n);
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+    threads = min<unsigned>(threads, max<size_t>(n, 1));
+
+    // each worker takes the next source and fills its rows
+    Dijkstra dijkstra;
+    atomic<int> next = 0;
+    auto worker = [&]() {
+        SearchWorkspace ws;
+        ws.setAvoided(g, {}, {});
+        for (int s = next++; s < numVertex; s = next++) {
+            dijkstra.dijkstra(g, ws, ws.tree, s, mode);
+            double *d = dist.data() + (size_t) s * n;
+            int *p = pred.data() + (size_t) s * n;
+            for (int t = 0; t < numVertex; t++) {
+                d[t] = ws.tree.getDist(t);
+                p[t] = ws.tree.getParent(t);
+            }
+        }
+    };
+    vector<thread> pool;
+    for (unsigned i = 1; i < threads; i++) pool.emplace_back(worker);
+    worker();
+    for (auto &t : pool) t.join();
+
+    this->g = g;
+    this->mode = mode;
+    return true;
+}
+
+
+size_t AllPairs::bytes() const {
+    return dist.capacity() * sizeof(double) + pred.capacity() * sizeof(int);
+}
+
+
+Path AllPairs::bestPath(const int &start, const int &end) const {
+    if (g == nullptr) return {{}, INF};
+    int s = g->findVertexIdx(start), t = g->findVertexIdx(end);
+    if (s == -1 || t == -1 || getDist(s, t) == INF) return {{}, INF};
+
+    Path res = {{}, getDist(s, t)};
+    const int *p = pred.data() + (size_t) s * n;
+    for (int v = t; v != -1; v = p[v]) res.path.push_back(g->getID(v));
+    reverse(res.path.begin(), res.path.end());
+    return res;
+}
@@ -0,0 +1,351 @@
+#include "../headers/ContractionHierarchy.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <queue>
+
+using namespace std;
+
+static const char CH_MAGIC[4] = {'D', 'A', 'C', 'H'};
+static constexpr uint32_t CH_VERSION = 2;
+static constexpr unsigned WITNESS_SETTLE_LIMIT = 500; // witness searches give up after settling this many vertices
+
+
+ContractionHierarchy::ContractionHierarchy() {
+    offsets.push_back(0);
+}
+
+
+ContractionHierarchy::ContractionHierarchy(const CsrGraph *g, const int mode) : g(g), mode(mode) {
+    contract();
+}
+
+
+unsigned ContractionHierarchy::getNumShortcuts() const {
+    return count_if(middles.begin(), middles.end(), [](int m) { return m != -1; });
+}
+
+
+void ContractionHierarchy::contract() {
+    const int n = g->getNumVertex();
+    vector<vector<Arc>> adj(n);
+    // keeps a single arc per pair of vertices, the lightest one
+    auto addArc = [&adj](int u, int v, double w, int middle) {
+        for (auto &a : adj[u]) {
+            if (a.to != v) continue;
+            if (w < a.weight) a = {v, w, middle};
+            return;
+        }
+        adj[u].push_back({v, w, middle});
+    };
+    for (int u = 0; u < n; u++) {
+        for (unsigned e = g->edgeBegin(mode, u); e < g->edgeEnd(mode, u); e++) {
+            int v = g->getTarget(mode, e);
+            if (v == u) continue;
+            addArc(u, v, g->getWeight(mode, e), -1);
+            addArc(v, u, g->getWeight(mode, e), -1);
+        }
+    }
+
+    vector<char> contracted(n, 0);
+    vector<int> contractedNeighbours(n, 0);
+    SearchTree witness;
+
+    // distances from u to the vertices around it, without going through the vertex being contracted
+    auto witnessSearch = [&](int u, int skip, double limit) {
+        witness.reset(n);
+        witness.set(u, 0, -1);
+        MutablePriorityQueue<SearchNode> q;
+        q.insert(witness.node(u));
+        while (!q.empty()) {
+            int x = witness.indexOf(q.extractMin());
+            if (witness.getDist(x) > limit || ++witness.settled > WITNESS_SETTLE_LIMIT) break;
+            for (auto &a : adj[x]) {
+                if (contracted[a.to] || a.to == skip) continue;
+                if (witness.getDist(x) + a.weight >= witness.getDist(a.to)) continue;
+                bool reached = witness.getDist(a.to) != INF;
+                witness.set(a.to, witness.getDist(x) + a.weight, x);
+                if (reached) {
+                    q.decreaseKey(witness.node(a.to));
+                } else {
+                    q.insert(witness.node(a.to));
+                }
+            }
+        }
+    };
+
+    // shortcuts needed to contract v: pairs of neighbours whose best connection goes through v
+    vector<tuple<int, int, double>> shortcuts;
+    auto findShortcuts = [&](int v) {
+        shortcuts.clear();
+        vector<const Arc *> neighbours;
+        for (auto &a : adj[v]) {
+            if (!contracted[a.to]) neighbours.push_back(&a);
+        }
+        for (size_t i = 0; i < neighbours.size(); i++) {
+            double limit = 0;
+            for (size_t j = i + 1; j < neighbours.size(); j++) {
+                limit = max(limit, neighbours[i]->weight + neighbours[j]->weight);
+            }
+            if (i + 1 == neighbours.size()) break;
+            witnessSearch(neighbours[i]->to, v, limit);
+            for (size_t j = i + 1; j < neighbours.size(); j++) {
+                double via = neighbours[i]->weight + neighbours[j]->weight;
+                if (witness.getDist(neighbours[j]->to) > via) {
+                    shortcuts.emplace_back(neighbours[i]->to, neighbours[j]->to, via);
+                }
+            }
+        }
+        return (int) neighbours.size();
+    };
+    auto priority = [&](int v) {
+        int degree = findShortcuts(v);
+        return (int) shortcuts.size() - degree + contractedNeighbours[v];
+    };
+
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<>> order;
+    for (int v = 0; v < n; v++) order.emplace(priority(v), v);
+
+    rank.assign(n, -1);
+    int next = 0;
+    while (!order.empty()) {
+        int v = order.top().second;
+        order.pop();
+        if (contracted[v]) continue;
+        // lazy update: contract v only if it is still the least important vertex
+        int p = priority(v);
+        if (!order.empty() && p > order.top().first) {
+            order.emplace(p, v);
+            continue;
+        }
+
+        for (auto [a, b, w] : shortcuts) {
+            addArc(a, b, w, v);
+            addArc(b, a, w, v);
+        }
+        contracted[v] = 1;
+        rank[v] = next++;
+        for (auto &a : adj[v]) contractedNeighbours[a.to]++;
+    }
+
+    offsets.assign(n + 1, 0);
+    for (int v = 0; v < n; v++) {
+        for (auto &a : adj[v]) {
+            if (rank[a.to] > rank[v]) offsets[v + 1]++;
+        }
+    }
+    for (int v = 0; v < n; v++) offsets[v + 1] += offsets[v];
+    targets.resize(offsets[n]);
+    weights.resize(offsets[n]);
+    middles.resize(offsets[n]);
+    for (int v = 0; v < n; v++) {
+        unsigned e = offsets[v];
+        for (auto &a : adj[v]) {
+            if (rank[a.to] <= rank[v]) continue;
+            targets[e] = a.to;
+            weights[e] = a.weight;
+            middles[e] = a.middle;
+            e++;
+        }
+    }
+}
+
+
+/*
+ * FNV-1a of the edges of a mode (degree, target and weight of each), so that a hierarchy is only loaded for the
+ * distances it was built from.
+ */
+static uint64_t fingerprint(const CsrGraph *g, const int mode) {
+    uint64_t h = 14695981039346656037ULL;
+    auto add = [&h](const void *data, size_t size) {
+        for (size_t i = 0; i < size; i++) {
+            h ^= static_cast<const unsigned char *>(data)[i];
+            h *= 1099511628211ULL;
+        }
+    };
+    for (int u = 0; u < g->getNumVertex(); u++) {
+        uint32_t degree = g->edgeEnd(mode, u) - g->edgeBegin(mode, u);
+        add(&degree, sizeof(degree));
+        for (unsigned e = g->edgeBegin(mode, u); e < g->edgeEnd(mode, u); e++) {
+            int32_t target = g->getTarget(mode, e);
+            double weight = g->getWeight(mode, e);
+            add(&target, sizeof(target));
+            add(&weight, sizeof(weight));
+        }
+    }
+    return h;
+}
+
+
+template <class T>
+static void writeVector(ofstream &file, const vector<T> &v) {
+    uint64_t size = v.size();
+    file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+    file.write(reinterpret_cast<const char *>(v.data()), size * sizeof(T));
+}
+
+
+template <class T>
+static bool readVector(ifstream &file, vector<T> &v) {
+    uint64_t size = 0;
+    if (!file.read(reinterpret_cast<char *>(&size), sizeof(size))) return false;
+    if (size > (1ULL << 32)) return false;
+    v.resize(size);
+    return (bool) file.read(reinterpret_cast<char *>(v.data()), size * sizeof(T));
+}
+
+
+bool ContractionHierarchy::save(const std::string &fileName) const {
+    if (g == nullptr) return false;
+    ofstream file(fileName, ios::binary);
+    if (!file) return false;
+
+    vector<int> ids(g->getNumVertex());
+    for (int v = 0; v < g->getNumVertex(); v++) ids[v] = g->getID(v);
+    int32_t m = mode;
+    uint64_t hash = fingerprint(g, mode);
+    file.write(CH_MAGIC, sizeof(CH_MAGIC));
+    file.write(reinterpret_cast<const char *>(&CH_VERSION), sizeof(CH_VERSION));
+    file.write(reinterpret_cast<const char *>(&m), sizeof(m));
+    file.write(reinterpret_cast<const char *>(&hash), sizeof(hash));
+    writeVector(file, ids);
+    writeVector(file, rank);
+    writeVector(file, offsets);
+    writeVector(file, targets);
+    writeVector(file, weights);
+    writeVector(file, middles);
+    return (bool) file;
+}
+
+
+bool ContractionHierarchy::load(const std::string &fileName, const CsrGraph *g) {
+    *this = ContractionHierarchy();
+    ifstream file(fileName, ios::binary);
+    if (!file) return false;
+
+    char magic[sizeof(CH_MAGIC)];
+    uint32_t version = 0;
+    int32_t m = -1;
+    uint64_t hash = 0;
+    vector<int> ids;
+    ContractionHierarchy ch;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char *>(&version), sizeof(version));
+    file.read(reinterpret_cast<char *>(&m), sizeof(m));
+    file.read(reinterpret_cast<char *>(&hash), sizeof(hash));
+    if (!file || memcmp(magic, CH_MAGIC, sizeof(magic)) != 0 || version != CH_VERSION) return false;
+    if (m < 0 || m >= CsrGraph::NUM_MODES || hash != fingerprint(g, m)) return false;
+    if (!readVector(file, ids) || !readVector(file, ch.rank) || !readVector(file, ch.offsets)
+        || !readVector(file, ch.targets) || !readVector(file, ch.weights) || !readVector(file, ch.middles)) return false;
+
+    const int n = g->getNumVertex();
+    if ((int) ids.size() != n || (int) ch.rank.size() != n || (int) ch.offsets.size() != n + 1) return false;
+    vector<char> ranked(n, 0);
+    for (int v = 0; v < n; v++) {
+        if (ids[v] != g->getID(v)) return false;
+        // the ranks must be a permutation of 0..n-1
+        if (ch.rank[v] < 0 || ch.rank[v] >= n || ranked[ch.rank[v]]) return false;
+        ranked[ch.rank[v]] = 1;
+    }
+    size_t edges = ch.targets.size();
+    if (ch.offsets[0] != 0 || ch.offsets[n] != edges || ch.weights.size() != edges || ch.middles.size() != edges) return false;
+    for (int v = 0; v < n; v++) {
+        if (ch.offsets[v] > ch.offsets[v + 1]) return false;
+    }
+    // edges go up, and a shortcut bypasses a less important vertex joined by edges to both ends, so unpacking ends
+    for (int v = 0; v < n; v++) {
+        for (unsigned e = ch.offsets[v]; e < ch.offsets[v + 1]; e++) {
+            int to = ch.targets[e], middle = ch.middles[e];
+            if (to < 0 || to >= n || ch.rank[to] <= ch.rank[v] || !(ch.weights[e] >= 0)) return false;
+            if (middle == -1) continue;
+            if (middle < 0 || middle >= n || ch.rank[middle] >= ch.rank[v]) return false;
+            if (ch.findArc(middle, v) == ch.offsets[middle + 1] || ch.findArc(middle, to) == ch.offsets[middle + 1]) return false;
+        }
+    }
+
+    ch.g = g;
+    ch.mode = m;
+    *this = std::move(ch);
+    return true;
+}
+
+
+unsigned ContractionHierarchy::findArc(const int u, const int v) const {
+    int low = rank[u] < rank[v] ? u : v;
+    int high = low == u ? v : u;
+    unsigned e = offsets[low];
+    while (e < offsets[low + 1] && targets[e] != high) e++;
+    return e;
+}
+
+
+void ContractionHierarchy::unpack(const int u, const int v, vector<int> &path) const {
+    int middle = middles[findArc(u, v)];
+    if (middle == -1) {
+        path.push_back(g->getID(v));
+        return;
+    }
+    unpack(u, middle, path);
+    unpack(middle, v, path);
+}
+
+
+Path ContractionHierarchy::bestPath(SearchWorkspace &ws, const int &start, const int &end) const {
+    if (g == nullptr) return {{}, INF};
+    int s = g->findVertexIdx(start), t = g->findVertexIdx(end);
+    if (s == -1 || t == -1) return {{}, INF};
+
+    SearchTree &fwd = ws.tree, &bwd = ws.backward;
+    fwd.reset(g->getNumVertex());
+    bwd.reset(g->getNumVertex());
+    if (s == t) return {{start}, 0};
+
+    fwd.set(s, 0, -1);
+    bwd.set(t, 0, -1);
+    MutablePriorityQueue<SearchNode> qf, qb;
+    qf.insert(fwd.node(s));
+    qb.insert(bwd.node(t));
+
+    double best = INF;
+    int meet = -1;
+    while (true) {
+        // each side stops once its frontier cannot improve the best meeting point
+        bool f = !qf.empty() && qf.top()->dist < best;
+        bool b = !qb.empty() && qb.top()->dist < best;
+        if (!f && !b) break;
+        bool forward = f && (!b || qf.top()->dist <= qb.top()->dist);
+        SearchTree &tree = forward ? fwd : bwd;
+        SearchTree &other = forward ? bwd : fwd;
+        auto &q = forward ? qf : qb;
+
+        int u = tree.indexOf(q.extractMin());
+        tree.settled++;
+        if (other.getDist(u) != INF && tree.getDist(u) + other.getDist(u) < best) {
+            best = tree.getDist(u) + other.getDist(u);
+            meet = u;
+        }
+        for (unsigned e = offsets[u]; e < offsets[u + 1]; e++) {
+            int v = targets[e];
+            if (tree.getDist(u) + weights[e] >= tree.getDist(v)) continue;
+            bool reached = tree.getDist(v) != INF;
+            tree.set(v, tree.getDist(u) + weights[e], u);
+            if (reached) {
+                q.decreaseKey(tree.node(v));
+            } else {
+                q.insert(tree.node(v));
+            }
+        }
+    }
+    if (meet == -1) return {{}, INF};
+
+    vector<int> up;
+    for (int v = meet; v != -1; v = fwd.getParent(v)) up.push_back(v);
+    reverse(up.begin(), up.end());
+    Path res = {{start}, best};
+    for (size_t i = 0; i + 1 < up.size(); i++) unpack(up[i], up[i + 1], res.path);
+    for (int v = meet; bwd.getParent(v) != -1; v = bwd.getParent(v)) unpack(v, bwd.getParent(v), res.path);
+    return res;
+}
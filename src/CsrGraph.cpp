@@ -0,0 +1,314 @@
+#include "../headers/CsrGraph.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include "../headers/MappedFile.h"
+
+using namespace std;
+
+/*
+ * Snapshot file layout: a Header followed by the sections, each one an array starting at an 8-byte aligned offset.
+ * Sections, in order: ids, idIndex, sparseIndex, parking, latitude, longitude, nameOffsets, names, codeOffsets, codes,
+ * then offsets, targets and weights of each mode.
+ */
+static constexpr char SNAPSHOT_MAGIC[8] = {'D', 'A', 'G', 'R', 'A', 'P', 'H', '\0'};
+static constexpr uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+static constexpr int NUM_SECTIONS = 10 + 3 * CsrGraph::NUM_MODES;
+
+namespace {
+    struct Section {
+        uint64_t offset; // from the start of the file
+        uint64_t count; // number of elements
+    };
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder; // SNAPSHOT_BYTE_ORDER as written by the machine that saved the file
+        uint64_t fileSize;
+        Section sections[NUM_SECTIONS];
+    };
+}
+
+struct CsrGraph::Arrays {
+    vector<int> ids, idIndex, sparseIndex;
+    vector<char> parking;
+    vector<double> latitude, longitude;
+    vector<unsigned> nameOffsets, codeOffsets;
+    vector<char> names, codes;
+    array<Edges, NUM_MODES> edges;
+};
+
+
+// CSR edges of every mode from the adjacency lists of a graph, in the same order
+static array<CsrGraph::Edges, CsrGraph::NUM_MODES> edgesOf(const Graph<int> &g) {
+    array<CsrGraph::Edges, CsrGraph::NUM_MODES> res;
+    const auto vertices = g.getVertexSet();
+    const int n = vertices.size();
+
+    for (auto &a : res) {
+        a.offsets.assign(n + 1, 0);
+    }
+    for (int i = 0; i < n; i++) {
+        for (auto e : vertices[i]->getAdj()) {
+            int m = CsrGraph::modeIndex(e->getMode());
+            if (m != -1) res[m].offsets[i + 1]++;
+        }
+    }
+    for (auto &a : res) {
+        for (int i = 0; i < n; i++) a.offsets[i + 1] += a.offsets[i];
+        a.targets.resize(a.offsets[n]);
+        a.weights.resize(a.offsets[n]);
+    }
+
+    for (int i = 0; i < n; i++) {
+        unsigned next[CsrGraph::NUM_MODES];
+        for (int m = 0; m < CsrGraph::NUM_MODES; m++) next[m] = res[m].offsets[i];
+        for (auto e : vertices[i]->getAdj()) {
+            int m = CsrGraph::modeIndex(e->getMode());
+            if (m == -1) continue;
+            res[m].targets[next[m]] = g.findVertexIdx(e->getDest()->getID());
+            res[m].weights[next[m]] = e->getWeight();
+            next[m]++;
+        }
+    }
+    return res;
+}
+
+static const unsigned NO_EDGES[1] = {0};
+
+
+CsrGraph::CsrGraph() {
+    nameOffsets = codeOffsets = NO_EDGES;
+    for (auto &a : adj) a.offsets = NO_EDGES;
+}
+
+
+CsrGraph::CsrGraph(const Graph<int> &g) : CsrGraph(g, edgesOf(g)) {}
+
+
+CsrGraph::CsrGraph(const Graph<int> &g, array<Edges, NUM_MODES> edges) {
+    auto arrays = make_shared<Arrays>();
+    Arrays &a = *arrays;
+    const auto vertices = g.getVertexSet();
+    const int n = vertices.size();
+
+    a.ids.reserve(n);
+    a.parking.reserve(n);
+    a.nameOffsets.push_back(0);
+    a.codeOffsets.push_back(0);
+    for (auto v : vertices) {
+        a.ids.push_back(v->getID());
+        a.parking.push_back(v->getParking());
+        const string_view name = v->getName(), code = v->getCode();
+        a.names.insert(a.names.end(), name.begin(), name.end());
+        a.codes.insert(a.codes.end(), code.begin(), code.end());
+        a.nameOffsets.push_back(a.names.size());
+        a.codeOffsets.push_back(a.codes.size());
+    }
+    // the same bound as the IdIndex of the graph, so that one large ID does not make the index (and the snapshot) huge
+    const int denseLimit = min<size_t>(IdIndex::denseLimit(n), INT_MAX);
+    for (int v = 0; v < n; v++) {
+        const int id = a.ids[v];
+        if (id < 0 || id >= denseLimit) {
+            a.sparseIndex.push_back(v);
+            continue;
+        }
+        if (id >= (int) a.idIndex.size()) a.idIndex.resize(id + 1, -1);
+        a.idIndex[id] = v;
+    }
+    sort(a.sparseIndex.begin(), a.sparseIndex.end(), [&a](int u, int v) { return a.ids[u] < a.ids[v]; });
+    if (n > 0 && all_of(vertices.begin(), vertices.end(), [](auto v) { return v->hasCoordinates(); })) {
+        a.latitude.reserve(n);
+        a.longitude.reserve(n);
+        for (auto v : vertices) {
+            a.latitude.push_back(v->getLatitude());
+            a.longitude.push_back(v->getLongitude());
+        }
+    }
+    a.edges = std::move(edges);
+
+    ids = a.ids;
+    idIndex = a.idIndex;
+    sparseIndex = a.sparseIndex;
+    parking = a.parking;
+    latitude = a.latitude;
+    longitude = a.longitude;
+    nameOffsets = a.nameOffsets;
+    codeOffsets = a.codeOffsets;
+    names = a.names;
+    codes = a.codes;
+    for (int m = 0; m < NUM_MODES; m++) {
+        adj[m] = {a.edges[m].offsets, a.edges[m].targets, a.edges[m].weights};
+    }
+    storage = arrays;
+}
+
+
+bool CsrGraph::save(const std::string &fileName, std::string &error) const {
+    ofstream file(fileName, ios::binary);
+    if (!file) {
+        error = "Error opening file " + fileName;
+        return false;
+    }
+
+    const pair<const void *, uint64_t> sections[NUM_SECTIONS] = {
+        {ids.data(), ids.size_bytes()}, {idIndex.data(), idIndex.size_bytes()},
+        {sparseIndex.data(), sparseIndex.size_bytes()}, {parking.data(), parking.size_bytes()},
+        {latitude.data(), latitude.size_bytes()}, {longitude.data(), longitude.size_bytes()},
+        {nameOffsets.data(), nameOffsets.size_bytes()}, {names.data(), names.size_bytes()},
+        {codeOffsets.data(), codeOffsets.size_bytes()}, {codes.data(), codes.size_bytes()},
+        {adj[0].offsets.data(), adj[0].offsets.size_bytes()}, {adj[0].targets.data(), adj[0].targets.size_bytes()},
+        {adj[0].weights.data(), adj[0].weights.size_bytes()},
+        {adj[1].offsets.data(), adj[1].offsets.size_bytes()}, {adj[1].targets.data(), adj[1].targets.size_bytes()},
+        {adj[1].weights.data(), adj[1].weights.size_bytes()},
+    };
+    const size_t elementSize[NUM_SECTIONS] = {
+        sizeof(int), sizeof(int), sizeof(int), sizeof(char), sizeof(double), sizeof(double), sizeof(unsigned), sizeof(char),
+        sizeof(unsigned), sizeof(char), sizeof(unsigned), sizeof(int), sizeof(double), sizeof(unsigned), sizeof(int), sizeof(double)
+    };
+
+    Header header = {};
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.byteOrder = SNAPSHOT_BYTE_ORDER;
+    uint64_t offset = sizeof(Header);
+    for (int i = 0; i < NUM_SECTIONS; i++) {
+        offset = (offset + 7) / 8 * 8;
+        header.sections[i] = {offset, sections[i].second / elementSize[i]};
+        offset += sections[i].second;
+    }
+    header.fileSize = offset;
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    static const char padding[8] = {};
+    uint64_t written = sizeof(Header);
+    for (int i = 0; i < NUM_SECTIONS; i++) {
+        file.write(padding, header.sections[i].offset - written);
+        file.write(static_cast<const char *>(sections[i].first), sections[i].second);
+        written = header.sections[i].offset + sections[i].second;
+    }
+    if (!file) {
+        error = "Error writing file " + fileName;
+        return false;
+    }
+    return true;
+}
+
+
+bool CsrGraph::load(const std::string &fileName, std::string &error) {
+    auto file = make_shared<MappedFile>();
+    if (!file->open(fileName, error)) return false;
+    const string_view data = file->data();
+
+    Header header;
+    if (data.size() < sizeof(Header) || memcmp(data.data(), SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        error = fileName + " is not a graph snapshot";
+        return false;
+    }
+    memcpy(&header, data.data(), sizeof(Header));
+    if (header.version != SNAPSHOT_VERSION) {
+        error = fileName + " has snapshot version " + to_string(header.version) + ", expected " + to_string(SNAPSHOT_VERSION);
+        return false;
+    }
+    if (header.byteOrder != SNAPSHOT_BYTE_ORDER || header.fileSize != data.size()) {
+        error = fileName + " was written on another architecture or is truncated";
+        return false;
+    }
+
+    bool valid = true;
+    auto section = [&]<class T>(int i, span<const T> &view) {
+        const Section &s = header.sections[i];
+        if (s.offset % alignof(T) != 0 || s.offset > data.size() || s.count > (data.size() - s.offset) / sizeof(T)) {
+            valid = false;
+            return;
+        }
+        view = {reinterpret_cast<const T *>(data.data() + s.offset), s.count};
+    };
+    CsrGraph g;
+    section(0, g.ids);
+    section(1, g.idIndex);
+    section(2, g.sparseIndex);
+    section(3, g.parking);
+    section(4, g.latitude);
+    section(5, g.longitude);
+    section(6, g.nameOffsets);
+    section(7, g.names);
+    section(8, g.codeOffsets);
+    section(9, g.codes);
+    for (int m = 0; m < NUM_MODES; m++) {
+        section(10 + 3 * m, g.adj[m].offsets);
+        section(11 + 3 * m, g.adj[m].targets);
+        section(12 + 3 * m, g.adj[m].weights);
+    }
+
+    // the searches index these arrays without bounds checks, so their sizes and contents must be consistent
+    const size_t n = g.ids.size();
+    auto validOffsets = [n](span<const unsigned> offsets, size_t size) {
+        if (offsets.size() != n + 1 || offsets[0] != 0 || offsets[n] != size) return false;
+        for (size_t v = 0; v < n; v++) {
+            if (offsets[v] > offsets[v + 1]) return false;
+        }
+        return true;
+    };
+    valid = valid && g.parking.size() == n && g.latitude.size() == g.longitude.size()
+            && (g.latitude.empty() || g.latitude.size() == n)
+            && validOffsets(g.nameOffsets, g.names.size()) && validOffsets(g.codeOffsets, g.codes.size());
+    // every vertex is in exactly one of the ID indexes, the sparse one holding only IDs out of the dense range
+    valid = valid && g.idIndex.size() <= IdIndex::denseLimit(n);
+    size_t dense = 0;
+    for (size_t id = 0; valid && id < g.idIndex.size(); id++) {
+        const int v = g.idIndex[id];
+        valid = v >= -1 && v < (int) n && (v == -1 || g.ids[v] == (int) id);
+        if (v != -1) dense++;
+    }
+    valid = valid && dense + g.sparseIndex.size() == n;
+    for (size_t i = 0; valid && i < g.sparseIndex.size(); i++) {
+        const int v = g.sparseIndex[i];
+        valid = v >= 0 && v < (int) n && (g.ids[v] < 0 || g.ids[v] >= (int) g.idIndex.size())
+                && (i == 0 || g.ids[g.sparseIndex[i - 1]] < g.ids[v]);
+    }
+    for (int m = 0; valid && m < NUM_MODES; m++) {
+        valid = g.adj[m].weights.size() == g.adj[m].targets.size() && validOffsets(g.adj[m].offsets, g.adj[m].targets.size());
+        for (size_t e = 0; valid && e < g.adj[m].targets.size(); e++) {
+            // NaN and negative weights would break the searches
+            valid = g.adj[m].targets[e] >= 0 && g.adj[m].targets[e] < (int) n && g.adj[m].weights[e] >= 0;
+        }
+    }
+    if (!valid) {
+        error = fileName + " is a corrupted graph snapshot";
+        return false;
+    }
+
+    g.storage = file;
+    *this = g;
+    return true;
+}
+
+
+int CsrGraph::modeIndex(const TransportMode mode) {
+    switch (mode) {
+        case TransportMode::DRIVING: return 0;
+        case TransportMode::WALKING: return 1;
+        default: return -1;
+    }
+}
+
+
+int CsrGraph::getNumVertex() const {
+    return ids.size();
+}
+
+
+unsigned CsrGraph::getNumEdges(int mode) const {
+    return adj[mode].targets.size();
+}
+
+
+int CsrGraph::findVertexIdx(int id) const {
+    if (id >= 0 && id < (int) idIndex.size()) return idIndex[id];
+    auto it = lower_bound(sparseIndex.begin(), sparseIndex.end(), id, [this](int v, int key) { return ids[v] < key; });
+    return it != sparseIndex.end() && ids[*it] == id ? *it : -1;
+}
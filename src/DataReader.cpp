@@ -1,10 +1,53 @@
+#include <algorithm>
+#include <charconv>
 #include <fstream>
 #include <sstream>
+#include <thread>
 #include "../headers/DataReader.h"
+#include "../headers/Instrumentation.h"
+#include "../headers/MappedFile.h"
 
 using namespace std;
 
 
+// splits the next line off text, without its "\n" or "\r\n"
+static bool nextLine(string_view &text, string_view &line) {
+    if (text.empty()) return false;
+    size_t end = text.find('\n');
+    if (end == string_view::npos) {
+        line = text;
+        text = {};
+    }
+    else {
+        line = text.substr(0, end);
+        text.remove_prefix(end + 1);
+    }
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    return true;
+}
+
+
+// splits the next comma-separated field off line
+static string_view nextField(string_view &line) {
+    size_t end = line.find(',');
+    string_view field = line.substr(0, end);
+    line.remove_prefix(end == string_view::npos ? line.size() : end + 1);
+    return field;
+}
+
+
+template <class T>
+static bool parseNumber(string_view field, T &value) {
+    auto [end, ec] = from_chars(field.data(), field.data() + field.size(), value);
+    return ec == errc() && end == field.data() + field.size();
+}
+
+
+static string lineError(const string &fileName, unsigned lineNo, const string &reason) {
+    return fileName + ":" + to_string(lineNo) + ": " + reason;
+}
+
+
 DataReader::DataReader() {}
 
 
@@ -12,32 +55,51 @@ DataReader::~DataReader() {}
 
 
 void DataReader::readLocations(const std::string& fileName, Graph<int>& graph) {
-
+    ROUTING_PHASE(Phase::PARSE);
     ifstream file(fileName);
     if (!file) {
         cerr << "Error opening file " << fileName << endl;
         exit(1);
     }
 
-    string name, idStr, code, parkingStr;
+    string name, idStr, code, parkingStr, column;
     int id;
     bool parking;
 
     string line;
     getline(file, line);
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+
+    // optional Latitude and Longitude columns after the four mandatory ones
+    int latitudeCol = -1, longitudeCol = -1;
+    istringstream header(line);
+    for (int col = 0; getline(header, column, ','); col++) {
+        if (col < 4) continue;
+        if (column == "Latitude") latitudeCol = col - 4;
+        if (column == "Longitude") longitudeCol = col - 4;
+    }
 
     while (getline(file, line)) {
+        ROUTING_COUNT(rows);
+        if (!line.empty() && line.back() == '\r') line.pop_back();
         istringstream iss(line);
 
         getline(iss, name, ',');
         getline(iss, idStr, ',');
         getline(iss, code, ',');
-        getline(iss, parkingStr, '\r');
+        getline(iss, parkingStr, ',');
 
         id = stoi(idStr);
         parking = parkingStr == "1";
 
-        graph.addVertex(name, id, code, parking);
+        if (!graph.addVertex(name, id, code, parking)) continue;
+
+        if (latitudeCol == -1 || longitudeCol == -1) continue;
+        vector<string> extra;
+        while (getline(iss, column, ',')) extra.push_back(column);
+        if ((int) extra.size() <= max(latitudeCol, longitudeCol)) continue;
+        if (extra[latitudeCol].empty() || extra[longitudeCol].empty()) continue;
+        graph.findVertex(id)->setCoordinates(stod(extra[latitudeCol]), stod(extra[longitudeCol]));
     }
 
     file.close();
@@ -45,6 +107,7 @@ void DataReader::readLocations(const std::string& fileName, Graph<int>& graph) {
 
 
 void DataReader::readDistances(const std::string& fileName, Graph<int>& graph) {
+    ROUTING_PHASE(Phase::PARSE);
     ifstream file(fileName);
     if (!file) {
         cerr << "Error opening file " << fileName << endl;
@@ -58,6 +121,7 @@ void DataReader::readDistances(const std::string& fileName, Graph<int>& graph) {
     getline(file, line);
 
     while (getline(file, line)) {
+        ROUTING_COUNT(rows);
         istringstream iss(line);
         getline(iss, location1, ',');
         getline(iss, location2, ',');
@@ -66,11 +130,11 @@ void DataReader::readDistances(const std::string& fileName, Graph<int>& graph) {
 
         if (drivingStr != "X") {
             driving = stod(drivingStr);
-            if(!graph.addBidirectionalEdge(location1, location2, driving, "driving")) exit(1);
+            if(!graph.addBidirectionalEdge(location1, location2, driving, TransportMode::DRIVING)) exit(1);
         }
         if (walkingStr != "X") {
             walking = stod(walkingStr);
-            if(!graph.addBidirectionalEdge(location2, location1, walking, "walking")) exit(1);
+            if(!graph.addBidirectionalEdge(location2, location1, walking, TransportMode::WALKING)) exit(1);
         }
 
     }
@@ -78,9 +142,250 @@ void DataReader::readDistances(const std::string& fileName, Graph<int>& graph) {
 }
 
 
-void DataReader::readInputFile(const std::string& inFile, std::string& mode,
-        int &source, int &destination, std::vector<int>& avoidNodes,
-        std::vector<std::pair<int, int>>& avoidSegments, int& includeNode, int& maxWalking) {
+bool DataReader::loadLocations(const std::string& fileName, Graph<int>& graph, std::string& error) {
+    ROUTING_PHASE(Phase::PARSE);
+    MappedFile file;
+    if (!file.open(fileName, error)) return false;
+
+    string_view text = file.data(), line;
+    int latitudeCol = -1, longitudeCol = -1;
+    if (nextLine(text, line)) {
+        for (int col = 0; !line.empty(); col++) {
+            string_view column = nextField(line);
+            if (col < 4) continue;
+            if (column == "Latitude") latitudeCol = col - 4;
+            if (column == "Longitude") longitudeCol = col - 4;
+        }
+    }
+
+    vector<string_view> extra;
+    for (unsigned lineNo = 2; nextLine(text, line); lineNo++) {
+        if (line.empty()) continue;
+        ROUTING_COUNT(rows);
+        string_view name = nextField(line), idStr = nextField(line), code = nextField(line), parkingStr = nextField(line);
+
+        int id;
+        if (!parseNumber(idStr, id)) {
+            error = lineError(fileName, lineNo, "invalid location ID '" + string(idStr) + "'");
+            return false;
+        }
+        if (!graph.addVertex(name, id, code, parkingStr == "1")) {
+            error = lineError(fileName, lineNo, "duplicate location ID or code");
+            return false;
+        }
+
+        if (latitudeCol == -1 || longitudeCol == -1) continue;
+        extra.clear();
+        while (!line.empty()) extra.push_back(nextField(line));
+        if ((int) extra.size() <= max(latitudeCol, longitudeCol)) continue;
+        if (extra[latitudeCol].empty() || extra[longitudeCol].empty()) continue;
+        double latitude, longitude;
+        if (!parseNumber(extra[latitudeCol], latitude) || !parseNumber(extra[longitudeCol], longitude)) {
+            error = lineError(fileName, lineNo, "invalid coordinates");
+            return false;
+        }
+        graph.findVertex(id)->setCoordinates(latitude, longitude);
+    }
+    return true;
+}
+
+
+bool DataReader::loadDistances(const std::string& fileName, Graph<int>& graph, std::string& error) {
+    ROUTING_PHASE(Phase::PARSE);
+    MappedFile file;
+    if (!file.open(fileName, error)) return false;
+
+    string_view text = file.data(), line;
+    nextLine(text, line);
+
+    for (unsigned lineNo = 2; nextLine(text, line); lineNo++) {
+        if (line.empty()) continue;
+        ROUTING_COUNT(rows);
+        string_view location1 = nextField(line), location2 = nextField(line);
+        string_view drivingStr = nextField(line), walkingStr = nextField(line);
+        double driving, walking;
+
+        if (drivingStr != "X") {
+            if (!parseNumber(drivingStr, driving)) {
+                error = lineError(fileName, lineNo, "invalid driving time '" + string(drivingStr) + "'");
+                return false;
+            }
+            if (!graph.addBidirectionalEdge(location1, location2, driving, TransportMode::DRIVING)) {
+                error = lineError(fileName, lineNo, "unknown location");
+                return false;
+            }
+        }
+        if (walkingStr != "X") {
+            if (!parseNumber(walkingStr, walking)) {
+                error = lineError(fileName, lineNo, "invalid walking time '" + string(walkingStr) + "'");
+                return false;
+            }
+            if (!graph.addBidirectionalEdge(location2, location1, walking, TransportMode::WALKING)) {
+                error = lineError(fileName, lineNo, "unknown location");
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+
+bool DataReader::loadDistancesParallel(const std::string& fileName, const Graph<int>& graph, CsrGraph& network, unsigned threads, std::string& error) {
+    ROUTING_PHASE(Phase::PARSE);
+    MappedFile file;
+    if (!file.open(fileName, error)) return false;
+    string_view text = file.data(), line;
+    nextLine(text, line);
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+    const int n = graph.getNumVertex();
+    constexpr int NUM_MODES = CsrGraph::NUM_MODES;
+
+    struct Segment {
+        int a, b; // vertex positions, the edge goes both ways
+        double weight;
+    };
+    struct Chunk {
+        string_view text;
+        vector<Segment> segments[NUM_MODES];
+        vector<unsigned> count[NUM_MODES]; // edges of each source vertex, then the next position to write them
+        unsigned lines = 0;
+        unsigned errorLine = 0; // line of the chunk with the first error, 0 if none
+        string error;
+    };
+
+    // line-aligned chunks of about the same size
+    vector<Chunk> chunks;
+    const size_t chunkSize = text.size() / threads + 1;
+    while (!text.empty()) {
+        size_t end = text.find('\n', chunkSize - 1);
+        end = end == string_view::npos ? text.size() : end + 1;
+        chunks.emplace_back().text = text.substr(0, end);
+        text.remove_prefix(end);
+    }
+
+    auto parse = [&](Chunk &chunk) {
+        for (auto &c : chunk.count) c.assign(n, 0);
+        string_view rest = chunk.text, line;
+        while (nextLine(rest, line)) {
+            chunk.lines++;
+            if (line.empty()) continue;
+            string_view location1 = nextField(line), location2 = nextField(line);
+            string_view times[NUM_MODES] = {nextField(line), nextField(line)};
+            for (int m = 0; m < NUM_MODES; m++) {
+                if (times[m] == "X") continue;
+                double weight;
+                if (!parseNumber(times[m], weight)) {
+                    chunk.error = string("invalid ") + (m == 0 ? "driving" : "walking") + " time '" + string(times[m]) + "'";
+                    chunk.errorLine = chunk.lines;
+                    return;
+                }
+                int a = graph.findVertexIdx(location1), b = graph.findVertexIdx(location2);
+                if (a == -1 || b == -1) {
+                    chunk.error = "unknown location";
+                    chunk.errorLine = chunk.lines;
+                    return;
+                }
+                chunk.segments[m].push_back({a, b, weight});
+                chunk.count[m][a]++;
+                chunk.count[m][b]++;
+            }
+        }
+    };
+    // the edges of a chunk go after those of the previous chunks, keeping the order of the file
+    auto scatter = [&](Chunk &chunk, array<CsrGraph::Edges, NUM_MODES> &edges) {
+        for (int m = 0; m < NUM_MODES; m++) {
+            auto &next = chunk.count[m];
+            for (auto &s : chunk.segments[m]) {
+                edges[m].targets[next[s.a]] = s.b;
+                edges[m].weights[next[s.a]++] = s.weight;
+                edges[m].targets[next[s.b]] = s.a;
+                edges[m].weights[next[s.b]++] = s.weight;
+            }
+        }
+    };
+    auto runAll = [&](auto work) {
+        vector<thread> workers;
+        for (size_t c = 1; c < chunks.size(); c++) workers.emplace_back(work, ref(chunks[c]));
+        if (!chunks.empty()) work(chunks[0]);
+        for (auto &w : workers) w.join();
+    };
+
+    runAll(parse);
+    unsigned lineNo = 1;
+    for (auto &chunk : chunks) {
+        if (chunk.errorLine != 0) {
+            error = lineError(fileName, lineNo + chunk.errorLine, chunk.error);
+            return false;
+        }
+        lineNo += chunk.lines;
+        ROUTING_COUNT_N(rows, chunk.lines);
+    }
+
+    array<CsrGraph::Edges, NUM_MODES> edges;
+    for (int m = 0; m < NUM_MODES; m++) {
+        auto &offsets = edges[m].offsets;
+        offsets.assign(n + 1, 0);
+        unsigned total = 0;
+        for (int v = 0; v < n; v++) {
+            for (auto &chunk : chunks) {
+                unsigned count = chunk.count[m][v];
+                chunk.count[m][v] = total;
+                total += count;
+            }
+            offsets[v + 1] = total;
+        }
+        edges[m].targets.resize(total);
+        edges[m].weights.resize(total);
+    }
+    runAll([&](Chunk &chunk) { scatter(chunk, edges); });
+
+    network = CsrGraph(graph, std::move(edges));
+    return true;
+}
+
+
+bool DataReader::readMatrixRequest(const std::string& fileName, MatrixRequest& request, std::string& error) {
+    MappedFile file;
+    if (!file.open(fileName, error)) return false;
+    string_view text = file.data(), line;
+    request = MatrixRequest();
+
+    for (unsigned lineNo = 1; nextLine(text, line); lineNo++) {
+        if (line.empty()) continue;
+        size_t colon = line.find(':');
+        string_view key = line.substr(0, colon), value = colon == string_view::npos ? string_view() : line.substr(colon + 1);
+        if (key == "Mode") {
+            if (!parseTransportMode(string(value), request.mode) || request.mode == TransportMode::DRIVING_WALKING) {
+                error = lineError(fileName, lineNo, "invalid mode '" + string(value) + "'");
+                return false;
+            }
+        }
+        else if (key == "Sources" || key == "Targets") {
+            vector<int> &ids = key == "Sources" ? request.sources : request.targets;
+            while (!value.empty()) {
+                string_view field = nextField(value);
+                int id;
+                if (!parseNumber(field, id)) {
+                    error = lineError(fileName, lineNo, "invalid ID '" + string(field) + "'");
+                    return false;
+                }
+                ids.push_back(id);
+            }
+        }
+        else {
+            error = lineError(fileName, lineNo, "unknown field '" + string(key) + "'");
+            return false;
+        }
+    }
+    if (request.mode == TransportMode::NONE || request.sources.empty() || request.targets.empty()) {
+        error = fileName + ": Mode, Sources and Targets are required";
+        return false;
+    }
+    return true;
+}
+
+
+void DataReader::readInputFile(const std::string& inFile, std::vector<RouteRequest>& requests) {
 
     ifstream input(inFile);
     if(!input) {
@@ -89,8 +394,23 @@ void DataReader::readInputFile(const std::string& inFile, std::string& mode,
     }
 
     string line;
+    bool inRequest = false;
 
     while(getline(input, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) {
+            inRequest = false;
+            continue;
+        }
+        if (!inRequest) {
+            requests.emplace_back();
+            inRequest = true;
+        }
+        RouteRequest &request = requests.back();
+        TransportMode &mode = request.mode;
+        std::vector<int> &avoidNodes = request.avoidNodes;
+        std::vector<std::pair<int, int>> &avoidSegments = request.avoidSegments;
+
         istringstream iss(line);
 
         string discriminant, value;
@@ -99,17 +419,16 @@ void DataReader::readInputFile(const std::string& inFile, std::string& mode,
         getline(iss, value);
 
         if (discriminant == "Mode") {
-            mode = value;
-            if (mode != "driving" && mode != "walking" && mode != "driving-walking") {
+            if (!parseTransportMode(value, mode)) {
                 cerr << "Invalid input." << endl;
                 exit(1);
             }
         }
         else if (discriminant == "Source") {
-            source = stoi(value);
+            request.source = stoi(value);
         }
         else if (discriminant == "Destination") {
-            destination = stoi(value);
+            request.destination = stoi(value);
         }
         else if (discriminant == "AvoidNodes") {
             getline(iss, value);
@@ -137,13 +456,13 @@ void DataReader::readInputFile(const std::string& inFile, std::string& mode,
         else if (discriminant == "IncludeNode") {
             getline(iss, value);
             if (!value.empty()) {
-                includeNode = stoi(value);
+                request.includeNode = stoi(value);
             }
         }
         else if (discriminant == "MaxWalkTime") {
             getline(iss, value);
             if (!value.empty()) {
-                maxWalking = stoi(value);
+                request.maxWalking = stoi(value);
             }
         }
         else {
@@ -1,172 +1,423 @@
 #include "../headers/Dijsktra.h"
 
+#include <algorithm>
+#include <atomic>
 #include <climits>
+#include <memory>
+#include <queue>
+#include <set>
 #include <iostream>
 #include <fstream>
-#include <map>
 #include <sstream>
+#include <thread>
+#include "../headers/WalkingTableCache.h"
 
 using namespace std;
 
-bool Dijkstra::relax(Edge<int> *e) {
-    if (e->getOrig()->getDist() + e->getWeight() >= e->getDest()->getDist()) return false;
+bool Dijkstra::relax(SearchTree &tree, const int u, const int v, const double weight) const {
+    if (tree.getDist(u) + weight >= tree.getDist(v)) return false;
 
-    e->getDest()->setDist(e->getOrig()->getDist() + e->getWeight());
-    e->getDest()->setPath(e);
+    tree.set(v, tree.getDist(u) + weight, u);
+    ROUTING_COUNT(relaxations);
     return true;
 }
 
-void Dijkstra::dijkstra(Graph<int> *g, const int &start, const std::string &transportation_mode,
-                    const bool alternative, const vector<int> &avoid_nodes, const vector<pair<int,int>> &avoid_edges) {
-    vector<Edge<int> *> edges_to_revert;
+void Dijkstra::dijkstra(const CsrGraph *g, SearchWorkspace &ws, SearchTree &tree, const int start, const int mode, const int target, const double bound) const {
+    search<SearchQueue>(g, ws, tree, start, mode, target, bound);
+}
+
+template <class Queue>
+void Dijkstra::search(const CsrGraph *g, SearchWorkspace &ws, SearchTree &tree, const int start, const int mode, const int target, const double bound) const {
+    ROUTING_PHASE(Phase::SEARCH);
+    tree.reset(g->getNumVertex());
+    tree.set(start, 0, -1);
 
-    for (auto v : g->getVertexSet()) {
-        v->setDist(INF);
-        v->setPath(nullptr);
-        if (!alternative) v->setVisited(false);
+    Queue q(tree);
+    q.push(start);
+    while (!q.empty()) {
+        int u = q.pop();
+        if (tree.getDist(u) > bound) break;
+        tree.settled++;
+        ROUTING_COUNT(settled);
+        if (u == target) break;
+        for (unsigned e = g->edgeBegin(mode, u); e < g->edgeEnd(mode, u); e++) {
+            int v = g->getTarget(mode, e);
+            if (ws.isAvoided(v) || ws.isAvoided(u, v)) continue;
+
+            auto dist_old = tree.getDist(v);
+            if (relax(tree, u, v, g->getWeight(mode, e))) {
+                if (dist_old == INF) {
+                    q.push(v);
+                } else {
+                    q.decrease(v);
+                }
+            }
+        }
     }
+}
+
+template void Dijkstra::search<BinaryHeap>(const CsrGraph *, SearchWorkspace &, SearchTree &, int, int, int, double) const;
+template void Dijkstra::search<QuaternaryHeap>(const CsrGraph *, SearchWorkspace &, SearchTree &, int, int, int, double) const;
+template void Dijkstra::search<RadixHeap>(const CsrGraph *, SearchWorkspace &, SearchTree &, int, int, int, double) const;
+
+std::vector<int> Dijkstra::reconstructPath(const CsrGraph *g, const SearchTree &tree, const int end, const bool reversible) const {
+    ROUTING_PHASE(Phase::RECONSTRUCT);
+    std::vector<int> res;
+    if (tree.getDist(end) == INF) return res;
 
-    for (auto node : avoid_nodes) {
-        g->findVertex(node)->setVisited(true);
+    for (int v = end; v != -1; v = tree.getParent(v)) {
+        res.push_back(g->getID(v));
     }
+    if (reversible) reverse(res.begin(), res.end());
+    return res;
+}
+
+
+Path Dijkstra::bestPath(const CsrGraph *g, SearchWorkspace &ws, const int &start, const int &end, const TransportMode transportation_mode,
+                    const vector<int> &avoid_nodes, const vector<pair<int,int>> &avoid_edges) const {
+    int s = g->findVertexIdx(start), t = g->findVertexIdx(end);
+    int mode = CsrGraph::modeIndex(transportation_mode);
+    if (s == -1 || t == -1 || mode == -1) return {{}, INF};
+
+    ws.setAvoided(g, avoid_nodes, avoid_edges);
+    dijkstra(g, ws, ws.tree, s, mode, t);
+    return {reconstructPath(g, ws.tree, t), ws.tree.getDist(t)};
+}
+
+
+Path Dijkstra::bestPathBidirectional(const CsrGraph *g, SearchWorkspace &ws, const int &start, const int &end, const TransportMode transportation_mode,
+                    const vector<int> &avoid_nodes, const vector<pair<int,int>> &avoid_edges) const {
+    int s = g->findVertexIdx(start), t = g->findVertexIdx(end);
+    int mode = CsrGraph::modeIndex(transportation_mode);
+    if (s == -1 || t == -1 || mode == -1) return {{}, INF};
 
-    for (auto edge : avoid_edges) {
-        Vertex<int> *v = g->findVertex(edge.first);
-        auto e_driving = v->findEdge(edge.second, "drving");
-        auto e_walk = v->findEdge(edge.second, "walking");
-        /*
-        auto e = g->findVertex(edge.first)->findEdge(edge.second, transportation_mode);
-        */
-        if (e_driving != nullptr) {
-            e_driving->setAvoid(true);
-            edges_to_revert.push_back(e_driving);
+    ws.setAvoided(g, avoid_nodes, avoid_edges);
+    SearchTree &fwd = ws.tree, &bwd = ws.backward;
+    fwd.reset(g->getNumVertex());
+    bwd.reset(g->getNumVertex());
+    if (s == t) return {{start}, 0};
+    if (ws.isAvoided(t)) return {{}, INF};
+
+    fwd.set(s, 0, -1);
+    bwd.set(t, 0, -1);
+    MutablePriorityQueue<SearchNode> qf, qb;
+    qf.insert(fwd.node(s));
+    qb.insert(bwd.node(t));
+
+    double best = INF;
+    int meet = -1;
+    while (!qf.empty() && !qb.empty()) {
+        if (qf.top()->dist + qb.top()->dist >= best) break;
+
+        // expand the side whose frontier is closer to its origin
+        bool forward = qf.top()->dist <= qb.top()->dist;
+        SearchTree &tree = forward ? fwd : bwd;
+        SearchTree &other = forward ? bwd : fwd;
+        auto &q = forward ? qf : qb;
+
+        int u = tree.indexOf(q.extractMin());
+        tree.settled++;
+        for (unsigned e = g->edgeBegin(mode, u); e < g->edgeEnd(mode, u); e++) {
+            int v = g->getTarget(mode, e);
+            // the backward search walks the edge v -> u of the forward route
+            if (ws.isAvoided(v) || (forward ? ws.isAvoided(u, v) : ws.isAvoided(v, u))) continue;
+
+            auto dist_old = tree.getDist(v);
+            if (relax(tree, u, v, g->getWeight(mode, e))) {
+                if (dist_old == INF) {
+                    q.insert(tree.node(v));
+                } else {
+                    q.decreaseKey(tree.node(v));
+                }
+            }
+            if (other.getDist(v) != INF && tree.getDist(v) + other.getDist(v) < best) {
+                best = tree.getDist(v) + other.getDist(v);
+                meet = v;
+            }
         }
-        e_walk->setAvoid(true);
+    }
+    if (meet == -1) return {{}, INF};
+
+    Path res = {reconstructPath(g, fwd, meet), best};
+    for (int v = bwd.getParent(meet); v != -1; v = bwd.getParent(v)) {
+        res.path.push_back(g->getID(v));
+    }
+    return res;
+}
 
-        edges_to_revert.push_back(e_walk);
+
+// weight of the lightest edge from u to v
+static double edgeWeight(const CsrGraph *g, const int mode, const int u, const int v) {
+    double res = INF;
+    for (unsigned e = g->edgeBegin(mode, u); e < g->edgeEnd(mode, u); e++) {
+        if (g->getTarget(mode, e) == v) res = min(res, g->getWeight(mode, e));
     }
+    return res;
+}
 
-    auto s = g->findVertex(start);
-    s->setDist(0);
 
-    MutablePriorityQueue<Vertex<int>> q;
-    q.insert(s);
-    while (!q.empty()) {
-        auto v = q.extractMin();
-        for (auto e : v->getAdj()) {
-            if (e->getLabel() == transportation_mode && !e->getDest()->isVisited() && !e->shouldAvoid()) {
-                auto dist_old = e->getDest()->getDist();
-                if (relax(e)) {
-                    if (dist_old == INF) {
-                        q.insert(e->getDest());
-                    } else {
-                        q.decreaseKey(e->getDest());
-                    }
+std::vector<Path> Dijkstra::kShortestPaths(const CsrGraph *g, SearchWorkspace &ws, const Path &best, const TransportMode transportation_mode, const unsigned k, const Disjointness disjointness,
+                    const vector<int> &avoid_nodes, const vector<pair<int,int>> &avoid_edges) const {
+    vector<Path> res;
+    int mode = CsrGraph::modeIndex(transportation_mode);
+    if (best.path.empty() || k == 0 || mode == -1) return res;
+    res.push_back(best);
+    const int start = best.path.front(), end = best.path.back();
+
+    if (disjointness == Disjointness::NODE_DISJOINT) {
+        vector<int> nodes = avoid_nodes;
+        vector<pair<int, int>> edges = avoid_edges;
+        while (res.size() < k) {
+            const vector<int> &last = res.back().path;
+            nodes.insert(nodes.end(), last.begin(), last.end() - 1);
+            for (size_t i = 0; i + 1 < last.size(); i++) edges.emplace_back(last[i], last[i + 1]);
+            Path next = bestPath(g, ws, start, end, transportation_mode, nodes, edges);
+            if (next.weight == INF) break;
+            res.push_back(next);
+        }
+        return res;
+    }
+
+    struct Candidate {
+        double weight;
+        vector<int> path; // vertex indexes
+        size_t deviation; // position of the node where it leaves the path it was derived from
+
+        bool operator>(const Candidate &c) const {
+            if (weight != c.weight) return weight > c.weight;
+            if (path.size() != c.path.size()) return path.size() > c.path.size();
+            return path > c.path;
+        }
+    };
+    const int t = g->findVertexIdx(end);
+    vector<Candidate> found = {{best.weight, {}, 0}};
+    for (int id : best.path) found[0].path.push_back(g->findVertexIdx(id));
+    priority_queue<Candidate, vector<Candidate>, greater<>> candidates;
+    set<vector<int>> seen = {found[0].path};
+
+    // distances to the end node with the avoided nodes only; the edges of the graph are bidirectional
+    ws.setAvoided(g, avoid_nodes, {});
+    dijkstra(g, ws, ws.backward, t, mode);
+    const SearchTree &toEnd = ws.backward;
+
+    while (found.size() < k) {
+        const vector<int> prev = found.back().path;
+        double rootWeight = 0;
+        for (size_t i = 0; i < found.back().deviation; i++) rootWeight += edgeWeight(g, mode, prev[i], prev[i + 1]);
+
+        for (size_t i = found.back().deviation; i + 1 < prev.size(); i++) {
+            // the deviation cannot go back through the root, nor take the next edge of a path found with the same root
+            vector<int> nodes = avoid_nodes;
+            vector<pair<int, int>> edges = avoid_edges;
+            for (size_t j = 0; j < i; j++) nodes.push_back(g->getID(prev[j]));
+            for (auto &p : found) {
+                if (p.path.size() > i + 1 && equal(prev.begin(), prev.begin() + i + 1, p.path.begin())) {
+                    edges.emplace_back(g->getID(p.path[i]), g->getID(p.path[i + 1]));
                 }
             }
+            ws.setAvoided(g, nodes, edges);
+
+            const int spur = prev[i];
+            Candidate c = {rootWeight, vector<int>(prev.begin(), prev.begin() + i), i};
+            // the tree path is a shortest one whenever it respects the restrictions of this deviation
+            bool treePath = toEnd.getDist(spur) != INF;
+            for (int v = spur; treePath && v != t; v = toEnd.getParent(v)) {
+                int next = toEnd.getParent(v);
+                treePath = !ws.isAvoided(next) && !ws.isAvoided(v, next);
+            }
+            rootWeight += edgeWeight(g, mode, prev[i], prev[i + 1]);
+            if (treePath) {
+                for (int v = spur; v != -1; v = toEnd.getParent(v)) c.path.push_back(v);
+                c.weight += toEnd.getDist(spur);
+            } else {
+                dijkstra(g, ws, ws.tree, spur, mode, t);
+                if (ws.tree.getDist(t) == INF) continue;
+                size_t root = c.path.size();
+                for (int v = t; v != -1; v = ws.tree.getParent(v)) c.path.push_back(v);
+                reverse(c.path.begin() + root, c.path.end());
+                c.weight += ws.tree.getDist(t);
+            }
+            if (seen.insert(c.path).second) candidates.push(std::move(c));
         }
+        if (candidates.empty()) break;
+        found.push_back(candidates.top());
+        candidates.pop();
     }
-    for (auto e : edges_to_revert) {
-        e->setAvoid(false);
+
+    for (size_t i = 1; i < found.size(); i++) {
+        Path p = {{}, found[i].weight};
+        for (int v : found[i].path) p.path.push_back(g->getID(v));
+        res.push_back(p);
     }
+    return res;
 }
 
-std::vector<int> Dijkstra::reconstructPath(Graph<int> *g, const int &start, const int &end, const bool reversible=true) {
-    std::vector<int> res;
 
-    auto v = g->findVertex(end);
-    if (v == nullptr || v->getDist() == INF) return res;
+std::vector<double> Dijkstra::oneToMany(const CsrGraph *g, SearchWorkspace &ws, const int &start, const std::vector<int> &targets, const TransportMode transportation_mode,
+                    const vector<int> &avoid_nodes, const vector<pair<int,int>> &avoid_edges) const {
+    vector<double> res(targets.size(), INF);
+    int s = g->findVertexIdx(start);
+    int mode = CsrGraph::modeIndex(transportation_mode);
+    if (s == -1 || mode == -1) return res;
 
-    res.push_back(v->getID());
-    while (v->getPath() != nullptr) {
-        v = v->getPath()->getOrig();
-        v->setVisited(true);
-        res.push_back(v->getID());
+    ws.setAvoided(g, avoid_nodes, avoid_edges);
+    ws.pendingTarget.resize(g->getNumVertex(), 0);
+    unsigned pending = 0;
+    for (int id : targets) {
+        int t = g->findVertexIdx(id);
+        if (t != -1 && !ws.pendingTarget[t]) {
+            ws.pendingTarget[t] = 1;
+            pending++;
+        }
     }
 
-    if (reversible) reverse(res.begin(), res.end());
-    if (res.empty() || (reversible ? res[0] : res.back()) != g->findVertex(start)->getID()) {
-        std::cout << res[0] << std::endl;
-        std::cout << g->findVertex(start)->getID() << std::endl;
-        for (auto r : res) std::cout << r << " ";
-        std::cout << "ERROR: Origin not found!" << std::endl;
+    SearchTree &tree = ws.tree;
+    tree.reset(g->getNumVertex());
+    tree.set(s, 0, -1);
+    SearchQueue q(tree);
+    q.push(s);
+    while (pending > 0 && !q.empty()) {
+        int u = q.pop();
+        tree.settled++;
+        if (ws.pendingTarget[u]) {
+            ws.pendingTarget[u] = 0;
+            pending--;
+        }
+        for (unsigned e = g->edgeBegin(mode, u); e < g->edgeEnd(mode, u); e++) {
+            int v = g->getTarget(mode, e);
+            if (ws.isAvoided(v) || ws.isAvoided(u, v)) continue;
+
+            auto dist_old = tree.getDist(v);
+            if (relax(tree, u, v, g->getWeight(mode, e))) {
+                if (dist_old == INF) {
+                    q.push(v);
+                } else {
+                    q.decrease(v);
+                }
+            }
+        }
+    }
+
+    // unreachable targets stay marked
+    for (size_t i = 0; i < targets.size(); i++) {
+        int t = g->findVertexIdx(targets[i]);
+        if (t == -1) continue;
+        ws.pendingTarget[t] = 0;
+        res[i] = tree.getDist(t);
     }
     return res;
 }
 
 
-std::vector<int> Dijkstra::bestPath(Graph<int> *g, const int &start, const int &end, const std::string &transportation_mode,
-                                const bool alternative, const vector<int> &avoid_nodes, const vector<pair<int,int>> &avoid_edges) {
-    dijkstra(g, start, transportation_mode, alternative, avoid_nodes, avoid_edges);
-    return reconstructPath(g, start, end);
+std::vector<double> Dijkstra::manyToMany(const CsrGraph *g, const std::vector<int> &sources, const std::vector<int> &targets, const TransportMode transportation_mode, unsigned threads,
+                    const vector<int> &avoid_nodes, const vector<pair<int,int>> &avoid_edges) const {
+    vector<double> res(sources.size() * targets.size(), INF);
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+    threads = min<unsigned>(threads, max<size_t>(sources.size(), 1));
+
+    // each worker takes the next source and writes its own row
+    atomic<size_t> next = 0;
+    auto worker = [&]() {
+        SearchWorkspace ws;
+        for (size_t i = next++; i < sources.size(); i = next++) {
+            auto row = oneToMany(g, ws, sources[i], targets, transportation_mode, avoid_nodes, avoid_edges);
+            copy(row.begin(), row.end(), res.begin() + i * targets.size());
+        }
+    };
+    vector<thread> pool;
+    for (unsigned i = 1; i < threads; i++) pool.emplace_back(worker);
+    worker();
+    for (auto &t : pool) t.join();
+    return res;
 }
 
 
-std::pair<std::pair<Path, Path>, std::pair<Path, Path>> Dijkstra::bestPathDriveWalk(Graph<int> *g, const int &start, const int &end, const int max_walking, std::string &message,
-                                const bool alternative=false, const vector<int> &avoid_nodes={}, const vector<pair<int,int>> &avoid_edges={}) {
-    std::map<int, Path> paths;
-    std::pair<Path, Path> res, res2;
-    dijkstra(g, start, "driving", alternative, avoid_nodes, avoid_edges);
-    for (auto v : g->getVertexSet()) {
-        if (!v->getParking()) continue;
-        if (v->getID() == start) continue;
-        if (v->getID() == end) continue;
+// walking time of a parking node of a walking table
+static double walkingTime(const WalkingTable &table, const int v) {
+    return table.dist[lower_bound(table.parking.begin(), table.parking.end(), v) - table.parking.begin()];
+}
 
-        auto p = reconstructPath(g, start, v->getID());
 
-        if (!p.empty()) {
-            paths[v->getID()] = {p, v->getDist()};
-        }
-    }
-    if (paths.empty()) {
+std::pair<std::pair<Path, Path>, std::pair<Path, Path>> Dijkstra::bestPathDriveWalk(const CsrGraph *g, SearchWorkspace &ws, const int &start, const int &end, const int max_walking, std::string &message,
+                                const vector<int> &avoid_nodes, const vector<pair<int,int>> &avoid_edges) const {
+    std::pair<Path, Path> res, res2;
+    int s = g->findVertexIdx(start), t = g->findVertexIdx(end);
+    if (s == -1 || t == -1) return {res, res2};
+    const int n = g->getNumVertex();
+    // parking spots where the route can switch from driving to walking
+    auto candidate = [&](int v) { return g->getParking(v) && v != s && v != t; };
+
+    // both searches only record distances; paths are rebuilt from their trees for the two routes returned
+    SearchTree &drive = ws.tree, &walk = ws.backward;
+    ws.setAvoided(g, avoid_nodes, avoid_edges);
+    dijkstra(g, ws, drive, s, CsrGraph::modeIndex(TransportMode::DRIVING));
+    int v = 0;
+    while (v < n && !(candidate(v) && drive.getDist(v) != INF)) v++;
+    if (v == n) {
         message = "no-parking";
-        if (max_walking == INF) {
+        if (max_walking == INT_MAX) {
             message = "no-parking-alternative";
             return {res, res2};
         }
-        return bestPathDriveWalk(g, start, end, INF, message);
+        return bestPathDriveWalk(g, ws, start, end, INT_MAX, message);
     }
 
     double lowest = INF;
     double lowestAlt = INF;
     double walkTime = 0;
-    bool valid_walkTime = false;
-    dijkstra(g, end, "walking", alternative, avoid_nodes, avoid_edges);
-    for (auto v : g->getVertexSet()) {
-        if (!v->getParking()) continue;
-        if (v->getID() == start) continue;
-        if (v->getID() == end) continue;
-        if (v->getDist() > max_walking) continue;
-        valid_walkTime = true;
-
-        auto p = reconstructPath(g, end, v->getID(), false);
-
-        if (!p.empty()) {
-            double pathWeight = v->getDist() + paths[v->getID()].weight;
-            if ((pathWeight < lowest) || (pathWeight == lowest && v->getDist() > walkTime)) {
-
-                lowestAlt = lowest;
-                lowest = v->getDist() + paths[v->getID()].weight;
-                walkTime = v->getDist();
-                res2 = res;
-                res.first = paths[v->getID()];
-                res.second = {p, v->getDist()};
-            }
-            else if (pathWeight < lowestAlt) {
-                lowestAlt = v->getDist() + paths[v->getID()].weight;
-                res2.first = paths[v->getID()];
-                res2.second = {p, v->getDist()};
-            }
+    int best = -1, alt = -1;
+    auto score = [&](int v, double dist) {
+        if (!candidate(v)) return;
+        if (dist > max_walking || drive.getDist(v) == INF) return;
+
+        double pathWeight = dist + drive.getDist(v);
+        if ((pathWeight < lowest) || (pathWeight == lowest && dist > walkTime)) {
+            lowestAlt = lowest;
+            lowest = pathWeight;
+            walkTime = dist;
+            alt = best;
+            best = v;
+        }
+        else if (pathWeight < lowestAlt) {
+            lowestAlt = pathWeight;
+            alt = v;
+        }
+    };
+    const int walkMode = CsrGraph::modeIndex(TransportMode::WALKING);
+    shared_ptr<const WalkingTable> table;
+    if (ws.walkingTables != nullptr) {
+        // the cached tables come from unbounded searches, which agree with bounded ones on every spot within max_walking
+        table = ws.walkingTables->find(g, t, avoid_nodes, avoid_edges);
+        if (table == nullptr) {
+            dijkstra(g, ws, walk, t, walkMode);
+            table = make_shared<WalkingTable>(g, walk);
+            ws.walkingTables->insert(g, t, avoid_nodes, avoid_edges, table);
         }
+        for (size_t i = 0; i < table->parking.size(); i++) score(table->parking[i], table->dist[i]);
     }
-    if (!valid_walkTime) {
+    else {
+        // parking spots farther than max_walking are skipped, so there is no need to settle them
+        dijkstra(g, ws, walk, t, walkMode, -1, max_walking == INT_MAX ? INF : max_walking);
+        for (v = 0; v < n; v++) score(v, walk.getDist(v));
+    }
+    if (best == -1) {
         message = "walking-time";
-        if (max_walking == INF) {
+        if (max_walking == INT_MAX) {
             message = "walking-time-alternative";
             return {res, res2};
         }
-        return bestPathDriveWalk(g, start, end, INF, message);
+        return bestPathDriveWalk(g, ws, start, end, INT_MAX, message);
+    }
+
+    if (table != nullptr) {
+        // the table has no routes: walk from the destination as far as the farther of the two parking nodes
+        dijkstra(g, ws, walk, t, walkMode, -1, max(walkingTime(*table, best), alt == -1 ? 0 : walkingTime(*table, alt)));
     }
+    auto route = [&](int v) {
+        Path walking = {reconstructPath(g, walk, v, false), walk.getDist(v)};
+        return std::pair<Path, Path>{{reconstructPath(g, drive, v), drive.getDist(v)}, walking};
+    };
+    res = route(best);
+    if (alt != -1) res2 = route(alt);
     return {res, res2};
 }
-
@@ -0,0 +1,133 @@
+#include "../headers/DriveWalkSearch.h"
+
+#include <climits>
+#include <cmath>
+
+using namespace std;
+
+/*
+ * States of the search, in ws.layered: vertex v of the walking layer is state v, and the best and second-best
+ * driving states of v are n + v and 2n + v. The parking node of driving state x is ws.labelParking[x - n].
+ * The search starts at the destination, so parents lead from the start towards it.
+ * Driving states are ordered by time, then by longer walking, as Dijkstra::bestPathDriveWalk ranks its routes; at
+ * equal times they are queued after the walking states, so that every parking node is offered before they settle,
+ * and a settled driving state gets the key INF so that later ties leave it alone.
+ */
+
+
+DriveWalkSearch::DriveWalkSearch() {}
+
+
+DriveWalkSearch::DriveWalkSearch(const CsrGraph *g) : g(g) {}
+
+
+std::pair<std::pair<Path, Path>, std::pair<Path, Path>> DriveWalkSearch::bestPath(SearchWorkspace &ws, const int &start, const int &end, const int max_walking, std::string &message,
+                                const vector<int> &avoid_nodes, const vector<pair<int,int>> &avoid_edges) const {
+    std::pair<Path, Path> res, res2;
+    if (g == nullptr) return {res, res2};
+    int s = g->findVertexIdx(start), t = g->findVertexIdx(end);
+    if (s == -1 || t == -1) return {res, res2};
+    const int n = g->getNumVertex();
+    const int drive = CsrGraph::modeIndex(TransportMode::DRIVING), walk = CsrGraph::modeIndex(TransportMode::WALKING);
+    const double budget = max_walking == INT_MAX ? INF : max_walking;
+    auto candidate = [&](int v) { return g->getParking(v) && v != s && v != t; };
+
+    ws.setAvoided(g, avoid_nodes, avoid_edges);
+    SearchTree &tree = ws.layered;
+    vector<int> &parking = ws.labelParking;
+    tree.reset(3 * n);
+    parking.resize(2 * n);
+    SearchQueue q(tree);
+    auto update = [&](int x, double dist, int parent) {
+        bool reached = tree.getDist(x) != INF;
+        double key = tree.node(x)->key;
+        tree.set(x, dist, parent);
+        if (x >= n) tree.setKey(x, nextafter(dist, INF));
+        if (!reached) {
+            q.push(x);
+        } else if (tree.node(x)->key < key) {
+            q.decrease(x);
+        }
+    };
+    auto settled = [&](int x) { return tree.getDist(x) != INF && tree.node(x)->key == INF; };
+    // whether a route through parking node p should replace that of driving state x
+    auto better = [&](int x, double dist, int p) {
+        if (dist != tree.getDist(x)) return dist < tree.getDist(x);
+        return dist != INF && !settled(x) && tree.getDist(p) > tree.getDist(parking[x - n]);
+    };
+    // keeps the two best driving routes of v through different parking nodes
+    auto offer = [&](int v, double dist, int p, int parent) {
+        int first = n + v, second = 2 * n + v;
+        if (tree.getDist(first) != INF && parking[v] == p) {
+            if (better(first, dist, p)) update(first, dist, parent);
+        } else if (better(first, dist, p) && !settled(second)) {
+            if (tree.getDist(first) != INF) {
+                parking[n + v] = parking[v];
+                update(second, tree.getDist(first), tree.getParent(first));
+            }
+            parking[v] = p;
+            update(first, dist, parent);
+        } else if (better(second, dist, p)) {
+            parking[n + v] = p;
+            update(second, dist, parent);
+        }
+    };
+
+    tree.set(t, 0, -1);
+    q.push(t);
+    int found = 0;
+    while (!q.empty()) {
+        int x = q.pop();
+        tree.settled++;
+        int v = x % n;
+        if (x < n) {
+            for (unsigned e = g->edgeBegin(walk, v); e < g->edgeEnd(walk, v); e++) {
+                int u = g->getTarget(walk, e);
+                if (ws.isAvoided(u) || ws.isAvoided(v, u)) continue;
+                double dist = tree.getDist(x) + g->getWeight(walk, e);
+                if (dist > budget || dist >= tree.getDist(u)) continue;
+                update(u, dist, x);
+            }
+            if (candidate(v)) offer(v, tree.getDist(x), v, x);
+            continue;
+        }
+        tree.setKey(x, INF);
+        // routes through the start twice are never better, so its states are not expanded
+        if (v == s) {
+            if (++found == 2) break;
+            continue;
+        }
+        for (unsigned e = g->edgeBegin(drive, v); e < g->edgeEnd(drive, v); e++) {
+            int u = g->getTarget(drive, e);
+            // the route drives from u to v; the start is the source of the driving part and is never avoided
+            if ((u != s && ws.isAvoided(u)) || ws.isAvoided(u, v)) continue;
+            offer(u, tree.getDist(x) + g->getWeight(drive, e), parking[x - n], x);
+        }
+    }
+
+    if (found == 0) {
+        // same messages as Dijkstra::bestPathDriveWalk: no parking node reachable by car, or none close enough to walk
+        Dijkstra().dijkstra(g, ws, ws.backward, s, drive);
+        bool reachable = false;
+        for (int v = 0; v < n && !reachable; v++) reachable = candidate(v) && ws.backward.getDist(v) != INF;
+        message = reachable ? "walking-time" : "no-parking";
+        if (max_walking == INT_MAX) {
+            message += "-alternative";
+            return {res, res2};
+        }
+        return bestPath(ws, start, end, INT_MAX, message);
+    }
+
+    auto route = [&](int x) {
+        std::pair<Path, Path> r;
+        double total = tree.getDist(x);
+        for (; x >= n; x = tree.getParent(x)) r.first.path.push_back(g->getID(x % n));
+        r.second.weight = tree.getDist(x);
+        r.first.weight = total - r.second.weight;
+        for (; x != -1; x = tree.getParent(x)) r.second.path.push_back(g->getID(x));
+        return r;
+    };
+    res = route(n + s);
+    if (tree.getDist(2 * n + s) != INF) res2 = route(2 * n + s);
+    return {res, res2};
+}
@@ -0,0 +1,95 @@
+#include "../headers/Instrumentation.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+
+using namespace std;
+
+static thread_local uint64_t allocationCount = 0, allocationBytes = 0;
+
+#ifdef ROUTING_INSTRUMENTATION
+// counts every allocation of the program; the other forms of operator new and delete call these
+void *operator new(size_t size) {
+    allocationCount++;
+    allocationBytes += size;
+    if (void *p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    free(p);
+}
+#endif
+
+
+StatsScope::StatsScope(QueryStats &stats) : stats(stats), previous(active), begin(chrono::steady_clock::now()) {
+    stats = QueryStats();
+    active = &stats;
+}
+
+
+StatsScope::~StatsScope() {
+    stats.totalMicros = chrono::duration<double, micro>(chrono::steady_clock::now() - begin).count();
+    active = previous;
+}
+
+
+PhaseTimer::PhaseTimer(const Phase phase) : stats(StatsScope::current()), phase(phase), allocations(allocationCount),
+                                            allocatedBytes(allocationBytes), begin(chrono::steady_clock::now()) {}
+
+
+PhaseTimer::~PhaseTimer() {
+    if (stats == nullptr) return;
+    stats->phaseMicros[(int) phase] += chrono::duration<double, micro>(chrono::steady_clock::now() - begin).count();
+    stats->allocations += allocationCount - allocations;
+    stats->allocatedBytes += allocationBytes - allocatedBytes;
+}
+
+
+void StatsHistogram::add(const QueryStats &stats) {
+    queries.push_back(stats);
+}
+
+
+void StatsHistogram::merge(const StatsHistogram &other) {
+    queries.insert(queries.end(), other.queries.begin(), other.queries.end());
+}
+
+
+void StatsHistogram::print(std::ostream &out, const std::string &title) const {
+    const pair<const char *, double (*)(const QueryStats &)> rows[] = {
+        {"total time (us)", [](const QueryStats &s) { return s.totalMicros; }},
+        {"parse time (us)", [](const QueryStats &s) { return s.phaseMicros[(int) Phase::PARSE]; }},
+        {"search time (us)", [](const QueryStats &s) { return s.phaseMicros[(int) Phase::SEARCH]; }},
+        {"reconstruct time (us)", [](const QueryStats &s) { return s.phaseMicros[(int) Phase::RECONSTRUCT]; }},
+        {"settled vertices", [](const QueryStats &s) { return (double) s.settled; }},
+        {"relaxations", [](const QueryStats &s) { return (double) s.relaxations; }},
+        {"queue pushes", [](const QueryStats &s) { return (double) s.pushes; }},
+        {"queue decrease-keys", [](const QueryStats &s) { return (double) s.decreases; }},
+        {"queue pops", [](const QueryStats &s) { return (double) s.pops; }},
+        {"rows parsed", [](const QueryStats &s) { return (double) s.rows; }},
+        {"allocations", [](const QueryStats &s) { return (double) s.allocations; }},
+        {"allocated bytes", [](const QueryStats &s) { return (double) s.allocatedBytes; }},
+    };
+
+    out << title << " (" << queries.size() << " queries)" << endl;
+    if (queries.empty()) return;
+    out << "  " << left << setw(24) << "" << right << setw(12) << "p50" << setw(12) << "p95" << setw(12) << "p99" << endl;
+    vector<double> values(queries.size());
+    for (auto &[name, value] : rows) {
+        transform(queries.begin(), queries.end(), values.begin(), value);
+        sort(values.begin(), values.end());
+        if (values.back() == 0) continue; // not measured by these queries
+        auto percentile = [&values](double p) { return values[min(values.size() - 1, (size_t) (p / 100 * values.size()))]; };
+        out << "  " << left << setw(24) << name << right << fixed << setprecision(1)
+            << setw(12) << percentile(50) << setw(12) << percentile(95) << setw(12) << percentile(99) << endl;
+    }
+    out.unsetf(ios::floatfield);
+    out << setprecision(6);
+}
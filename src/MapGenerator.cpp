@@ -0,0 +1,202 @@
+#include "../headers/MapGenerator.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+static constexpr double DENSITY = 4; // locations per square kilometer
+static constexpr double ORIGIN_LATITUDE = 41.15, ORIGIN_LONGITUDE = -8.61;
+static constexpr double KM_PER_DEGREE = 111.2;
+static constexpr double MAX_REACH = 8; // largest reach of a hub, relative to the radius of the map
+
+
+// uniform in [0, 1), computed without the distributions of <random>, which differ between standard libraries
+static double uniform(mt19937_64 &rng) {
+    return (rng() >> 11) * 0x1.0p-53;
+}
+
+
+namespace {
+    // output file written through a large buffer
+    class CsvWriter {
+    public:
+        explicit CsvWriter(const string &fileName) : file(fileName, ios::binary) {}
+        ~CsvWriter() { flush(); }
+        bool good() const { return (bool) file; }
+        CsvWriter &operator<<(string_view text) {
+            buffer.append(text);
+            if (buffer.size() >= (1 << 20)) flush();
+            return *this;
+        }
+        template <class Integer> requires is_integral_v<Integer>
+        CsvWriter &operator<<(Integer number) {
+            char text[24];
+            return *this << string_view(text, to_chars(text, text + sizeof(text), number).ptr - text);
+        }
+        // coordinate with 6 decimal places, about 10 cm
+        CsvWriter &operator<<(double number) {
+            char text[64];
+            return *this << string_view(text, to_chars(text, text + sizeof(text), number, chars_format::fixed, 6).ptr - text);
+        }
+        void flush() {
+            file.write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+
+    private:
+        ofstream file;
+        string buffer;
+    };
+}
+
+
+MapGenerator::MapGenerator(const MapOptions &options) : options(options) {}
+
+
+bool MapGenerator::validate(std::string &error) const {
+    const MapOptions &o = options;
+    if (o.vertices == 0 || o.vertices > (unsigned) INT32_MAX) error = "the number of locations must be between 1 and 2^31 - 1";
+    else if (!(o.averageDegree > 0 && o.averageDegree <= 1000)) error = "the average degree must be between 0 and 1000";
+    else if (o.degreeShape == DegreeShape::POWER_LAW && !(o.degreeExponent > 1)) error = "the degree exponent must be greater than 1";
+    else if (!(o.parkingDensity >= 0 && o.parkingDensity <= 1)) error = "the parking density must be between 0 and 1";
+    else if (!(o.noDriving >= 0 && o.noWalking >= 0 && o.noDriving + o.noWalking <= 1)) {
+        error = "the fractions of segments without driving and without walking must add up to at most 1";
+    }
+    else if (!(o.minDrivingSpeed > 0 && o.minDrivingSpeed <= o.maxDrivingSpeed && o.walkingSpeed > 0)) {
+        error = "the speeds must be positive, with the minimum driving speed not above the maximum";
+    }
+    else return true;
+    return false;
+}
+
+
+bool MapGenerator::write(const std::string &locationsFile, const std::string &distancesFile, std::string &error) {
+    segments = 0;
+    if (!validate(error)) return false;
+    CsvWriter locations(locationsFile), distances(distancesFile);
+    if (!locations.good() || !distances.good()) {
+        error = "Error opening file " + (locations.good() ? distancesFile : locationsFile);
+        return false;
+    }
+    mt19937_64 rng(options.seed);
+    const unsigned n = options.vertices;
+    const bool grid = options.topology == MapTopology::GRID;
+    const double side = sqrt(n / DENSITY); // km
+
+    // positions in km from the south-west corner
+    vector<float> x(n), y(n);
+    const unsigned columns = max(1u, (unsigned) ceil(sqrt((double) n)));
+    for (unsigned i = 0; i < n; i++) {
+        if (grid) {
+            x[i] = (i % columns) / sqrt(DENSITY);
+            y[i] = (i / columns) / sqrt(DENSITY);
+        } else {
+            x[i] = uniform(rng) * side;
+            y[i] = uniform(rng) * side;
+        }
+    }
+
+    locations << "Location,Id,Code,Parking,Latitude,Longitude\n";
+    const double kmPerLongitude = KM_PER_DEGREE * cos(ORIGIN_LATITUDE * M_PI / 180);
+    for (unsigned i = 0; i < n; i++) {
+        int parking = uniform(rng) < options.parkingDensity;
+        locations << "P" << i << "," << i + 1 << ",C" << i << "," << parking << ","
+                  << ORIGIN_LATITUDE + y[i] / KM_PER_DEGREE << "," << ORIGIN_LONGITUDE + x[i] / kmPerLongitude << "\n";
+    }
+
+    // roads are longer than the straight line between their ends, and slower in some places than in others
+    distances << "Location1,Location2,Driving,Walking\n";
+    auto segment = [&](unsigned a, unsigned b, double km) {
+        km *= 1 + 2 * uniform(rng);
+        double drivingSpeed = options.minDrivingSpeed + (options.maxDrivingSpeed - options.minDrivingSpeed) * uniform(rng);
+        double closed = uniform(rng);
+        long driving = max(1L, lround(km / drivingSpeed * 60));
+        long walking = max(1L, lround(km / options.walkingSpeed * 60));
+        distances << "C" << a << ",C" << b << ",";
+        if (closed < options.noDriving) distances << "X," << walking << "\n";
+        else if (closed < options.noDriving + options.noWalking) distances << driving << ",X\n";
+        else distances << driving << "," << walking << "\n";
+        segments++;
+    };
+
+    if (grid) {
+        for (unsigned i = 0; i < n; i++) {
+            if ((i + 1) % columns != 0 && i + 1 < n) segment(i, i + 1, 1 / sqrt(DENSITY));
+            if (i + columns < n) segment(i, i + columns, 1 / sqrt(DENSITY));
+        }
+    } else {
+        // two locations are linked if they are closer than the reach of either one, radius * reach[i];
+        // with POISSON every reach is 1, with POWER_LAW P(reach > r) = r^(-2 * degreeExponent), up to MAX_REACH
+        vector<float> reach;
+        double meanSquare = 1; // mean of max(reach[i], reach[j])^2 over the pairs of locations
+        if (options.degreeShape == DegreeShape::POWER_LAW) {
+            reach.resize(n);
+            for (auto &r : reach) r = min(MAX_REACH, pow(1 - uniform(rng), -0.5 / options.degreeExponent));
+            vector<float> sorted = reach;
+            sort(sorted.begin(), sorted.end());
+            meanSquare = 0;
+            for (unsigned k = 0; k < n; k++) meanSquare += (double) sorted[k] * sorted[k] * (2.0 * k + 1) / n / n;
+        }
+        auto reachOf = [&reach](unsigned p) { return reach.empty() ? 1.0 : (double) reach[p]; };
+        const double radius = sqrt(options.averageDegree / (M_PI * DENSITY * meanSquare));
+
+        // points sorted into square cells as wide as the radius
+        const unsigned cells = max(1u, (unsigned) min(side / radius, sqrt((double) n)));
+        auto cellOf = [&](float coordinate) { return min(cells - 1, (unsigned) (coordinate / side * cells)); };
+        const double cellSize = side / cells;
+        vector<unsigned> offsets((size_t) cells * cells + 1, 0), points(n);
+        for (unsigned i = 0; i < n; i++) offsets[(size_t) cellOf(y[i]) * cells + cellOf(x[i]) + 1]++;
+        for (size_t c = 0; c + 1 < offsets.size(); c++) offsets[c + 1] += offsets[c];
+        for (unsigned i = 0; i < n; i++) points[offsets[(size_t) cellOf(y[i]) * cells + cellOf(x[i])]++] = i;
+        for (size_t c = offsets.size() - 1; c > 0; c--) offsets[c] = offsets[c - 1];
+        offsets[0] = 0;
+        // positions and reaches in the same order, so that the points of a cell are next to each other in memory
+        auto sortByCell = [&points](vector<float> &values) {
+            if (values.empty()) return;
+            vector<float> sorted(values.size());
+            for (size_t p = 0; p < points.size(); p++) sorted[p] = values[points[p]];
+            values.swap(sorted);
+        };
+        sortByCell(x);
+        sortByCell(y);
+        sortByCell(reach);
+
+        for (unsigned cy = 0; cy < cells; cy++) {
+            for (unsigned cx = 0; cx < cells; cx++) {
+                const size_t cell = (size_t) cy * cells + cx;
+                for (unsigned p = offsets[cell]; p < offsets[cell + 1]; p++) {
+                    const unsigned i = points[p];
+                    const double reachI = radius * reachOf(p);
+                    const unsigned range = ceil(reachI / cellSize);
+                    for (unsigned ny = cy > range ? cy - range : 0; ny <= min(cells - 1, cy + range); ny++) {
+                        for (unsigned nx = cx > range ? cx - range : 0; nx <= min(cells - 1, cx + range); nx++) {
+                            const size_t c = (size_t) ny * cells + nx;
+                            for (unsigned q = offsets[c]; q < offsets[c + 1]; q++) {
+                                const unsigned j = points[q];
+                                double km = hypot(x[p] - x[q], y[p] - y[q]);
+                                if (j == i || km >= reachI) continue;
+                                // a pair within the reach of both is written once, by the smaller index
+                                if (j < i && km < radius * reachOf(q)) continue;
+                                segment(i, j, km);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    locations.flush();
+    distances.flush();
+    if (!locations.good() || !distances.good()) {
+        error = "Error writing file " + (locations.good() ? distancesFile : locationsFile);
+        return false;
+    }
+    return true;
+}
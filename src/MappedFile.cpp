@@ -0,0 +1,70 @@
+#include "../headers/MappedFile.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+using namespace std;
+
+
+MappedFile::MappedFile() {}
+
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : ptr(exchange(other.ptr, nullptr)), length(exchange(other.length, 0)) {}
+
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+        close();
+        ptr = exchange(other.ptr, nullptr);
+        length = exchange(other.length, 0);
+    }
+    return *this;
+}
+
+
+bool MappedFile::open(const std::string &fileName, std::string &error) {
+    close();
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd == -1) {
+        error = "Error opening file " + fileName + ": " + strerror(errno);
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) == -1) {
+        error = "Error reading file " + fileName + ": " + strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    // an empty file cannot be mapped, it is just an empty view
+    if (info.st_size > 0) {
+        void *p = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            error = "Error mapping file " + fileName + ": " + strerror(errno);
+            ::close(fd);
+            return false;
+        }
+        madvise(p, info.st_size, MADV_SEQUENTIAL);
+        ptr = static_cast<const char *>(p);
+        length = info.st_size;
+    }
+    ::close(fd);
+    return true;
+}
+
+
+void MappedFile::close() {
+    if (ptr != nullptr) munmap(const_cast<char *>(ptr), length);
+    ptr = nullptr;
+    length = 0;
+}
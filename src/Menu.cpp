@@ -1,30 +1,161 @@
 #include "../headers/Menu.h"
 
+#include <atomic>
+#include <chrono>
 #include <climits>
 #include <iostream>
 #include <fstream>
 #include <map>
+#include <mutex>
 #include <sstream>
+#include <thread>
 
 #include "../headers/DataReader.h"
 #include "../headers/Dijsktra.h"
+#include "../headers/Instrumentation.h"
 
 using namespace std;
 
 
-Menu::Menu() = default;
+Menu::Menu() {}
 
 
-void Menu::readGraph() {
+bool Menu::readGraph() {
     DataReader reader = DataReader();
-    reader.readLocations("../docs/Locations.csv", graph);
-    reader.readDistances("../docs/Distances.csv", graph);
+    Graph<int> graph;
+    string error;
+#ifdef ROUTING_INSTRUMENTATION
+    QueryStats stats;
+    StatsScope scope(stats);
+#endif
+    // the distances go straight into the network, the graph only keeps the locations
+    if (!reader.loadLocations("../docs/Locations.csv", graph, error)
+        || !reader.loadDistancesParallel("../docs/Distances.csv", graph, network, 0, error)) {
+        cerr << error << endl;
+        return false;
+    }
+#ifdef ROUTING_INSTRUMENTATION
+    cout << "Loaded " << stats.rows << " rows in " << stats.phaseMicros[(int) Phase::PARSE] << " us, "
+         << stats.allocations << " allocations (" << stats.allocatedBytes / 1024 << " KiB)" << endl;
+#endif
+    walkingTables.clear();
+    for (auto &tables : allPairs) tables = AllPairs();
+    for (auto &ch : hierarchies) ch = ContractionHierarchy();
+    setRouteEngine(engine);
 
     /*
     reader.readLocations("../docs/LocSample.csv", graph);
     reader.readDistances("../docs/DisSample.csv", graph);
     */
+    return true;
+}
+
+
+bool Menu::loadSnapshot(const std::string &fileName) {
+    string error;
+    if (!network.load(fileName, error)) {
+        cerr << error << endl;
+        return false;
+    }
+    walkingTables.clear();
+    for (auto &tables : allPairs) tables = AllPairs();
+    for (auto &ch : hierarchies) ch = ContractionHierarchy();
+    setRouteEngine(engine);
+    return true;
+}
+
+
+bool Menu::saveSnapshot(const std::string &fileName) const {
+    string error;
+    if (!network.save(fileName, error)) {
+        cerr << error << endl;
+        return false;
+    }
+    return true;
+}
+
+
+bool Menu::buildAllPairs(const int maxVertices, const unsigned threads) {
+    string error;
+    auto startTime = chrono::steady_clock::now();
+    for (int m = 0; m < CsrGraph::NUM_MODES; m++) {
+        if (!allPairs[m].build(&network, m, threads, maxVertices, error)) {
+            for (auto &tables : allPairs) tables = AllPairs();
+            cerr << "All-pairs tables not built: " << error << endl;
+            return false;
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    cout << "All-pairs tables built in " << seconds << " s: " << (allPairs[0].bytes() + allPairs[1].bytes()) / (1024 * 1024)
+         << " MiB for " << network.getNumVertex() << " vertices" << endl;
+    return true;
+}
+
+
+bool Menu::loadHierarchies(const std::string &prefix) {
+    for (auto mode : {TransportMode::DRIVING, TransportMode::WALKING}) {
+        const string fileName = prefix + "." + toString(mode) + ".ch";
+        if (!hierarchies[CsrGraph::modeIndex(mode)].load(fileName, &network)) {
+            for (auto &ch : hierarchies) ch = ContractionHierarchy();
+            cerr << "Error loading file " << fileName << ": missing, malformed or built from other distances" << endl;
+            return false;
+        }
+    }
+    answers.clear();
+    return true;
+}
+
+
+Path Menu::unrestrictedPath(SearchWorkspace &ws, const int source, const int destination, const TransportMode mode) const {
+    int m = CsrGraph::modeIndex(mode);
+    if (m != -1 && allPairs[m].isBuilt()) return allPairs[m].bestPath(source, destination);
+    if (m != -1 && hierarchies[m].getMode() == m) return hierarchies[m].bestPath(ws, source, destination);
+    return routePath(ws, source, destination, mode);
+}
+
+
+Path Menu::routePath(SearchWorkspace &ws, const int source, const int destination, const TransportMode mode,
+                     const vector<int> &avoid_nodes, const vector<pair<int,int>> &avoid_edges) const {
+    switch (engine) {
+        case RouteEngine::BIDIRECTIONAL:
+            return dijkstra.bestPathBidirectional(&network, ws, source, destination, mode, avoid_nodes, avoid_edges);
+        case RouteEngine::ASTAR:
+            return astar.bestPath(ws, source, destination, mode, avoid_nodes, avoid_edges);
+        default:
+            return dijkstra.bestPath(&network, ws, source, destination, mode, avoid_nodes, avoid_edges);
+    }
+}
+
+
+std::pair<std::pair<Path, Path>, std::pair<Path, Path>> Menu::driveWalkPath(SearchWorkspace &ws, const int source, const int destination, const int maxWalking, string &message,
+                                                                           const vector<int> &avoid_nodes, const vector<pair<int,int>> &avoid_edges) const {
+    if (layeredSearch.isReady()) return layeredSearch.bestPath(ws, source, destination, maxWalking, message, avoid_nodes, avoid_edges);
+    return dijkstra.bestPathDriveWalk(&network, ws, source, destination, maxWalking, message, avoid_nodes, avoid_edges);
+}
+
+
+void Menu::setLayeredDriveWalk(const bool layered) {
+    layeredSearch = layered ? DriveWalkSearch(&network) : DriveWalkSearch();
+    answers.clear();
+}
+
+
+void Menu::setWalkingCache(const bool enabled) {
+    workspace.walkingTables = enabled ? &walkingTables : nullptr;
+    walkingTables.clear();
+}
+
+
+void Menu::setAlternatives(const Disjointness disjointness) {
+    alternatives = disjointness;
+    answers.clear();
+}
+
 
+void Menu::setRouteEngine(const RouteEngine routeEngine) {
+    engine = routeEngine;
+    answers.clear();
+    astar = engine == RouteEngine::ASTAR ? AStar(&network) : AStar();
 }
 
 
@@ -34,7 +165,7 @@ int Menu::getIntValue(const string &s, const bool &node) {
         cout << s;
         if (cin >> ret) {
             if (node) {
-                if (graph.findVertex(ret)) break;
+                if (network.findVertexIdx(ret) != -1) break;
                 cout << "ERROR: No such vertex!" << endl;
             } else {
                 break;
@@ -49,11 +180,13 @@ int Menu::getIntValue(const string &s, const bool &node) {
 }
 
 
-std::string Menu::getTransportationMode() {
-    std::string mode;
-    while (mode != "driving" && mode != "walking") {
-        cout << "Enter mode: "; cin >> mode;
-        if (mode != "driving" && mode != "walking") {
+TransportMode Menu::getTransportationMode() {
+    std::string input;
+    TransportMode mode = TransportMode::NONE;
+    while (mode != TransportMode::DRIVING && mode != TransportMode::WALKING) {
+        cout << "Enter mode: "; cin >> input;
+        if (!parseTransportMode(input, mode) || mode == TransportMode::DRIVING_WALKING) {
+            mode = TransportMode::NONE;
             cout << "ERROR: Wrong mode!" << endl;
         }
     }
@@ -111,31 +244,37 @@ int Menu::getIncludeNode() {
 }
 
 
-void Menu::displayInformationDriving(const int &source, const int &destination, const std::vector<int> &res, std::vector<std::pair<int, int>> &avoid_edges,
+void Menu::displayInformationDriving(const int &source, const int &destination, const Path &res, std::vector<std::pair<int, int>> &avoid_edges,
     const bool &alternative, const std::string &message) {
     if (!alternative) {
-        cout << "Source:" << graph.findVertex(source)->getID() << endl;
-        cout << "Destination:" << graph.findVertex(destination)->getID() << endl;
+        cout << "Source:" << source << endl;
+        cout << "Destination:" << destination << endl;
     }
     cout << message;
-    if (graph.findVertex(destination)->getDist() == INF) {
+    if (res.weight == INF) {
         cout << "none" << endl;
     }
     else {
-        for (int i = 0; i < res.size(); i++) {
+        for (int i = 0; i < res.path.size(); i++) {
             if (!alternative) {
-                if (i + 1 < res.size()) avoid_edges.emplace_back(res[i], res[i+1]);
+                if (i + 1 < res.path.size()) avoid_edges.emplace_back(res.path[i], res.path[i+1]);
             }
-            cout << res[i] << (i == res.size() - 1 ? "" : ",");
+            cout << res.path[i] << (i == res.path.size() - 1 ? "" : ",");
         }
-        cout << "(" << graph.findVertex(destination)->getDist() << ")" << endl;
+        cout << "(" << res.weight << ")" << endl;
     }
 }
 
 
+std::vector<int> Menu::alternativeAvoidNodes(const std::vector<int> &avoid_nodes, const Path &route) {
+    std::vector<int> res = avoid_nodes;
+    if (!route.path.empty()) res.insert(res.end(), route.path.begin(), route.path.end() - 1);
+    return res;
+}
+
+
 void Menu::MainMenu() {
     int option;
-    readGraph();
 
     do {
         cout << "\nIndividual Route Planning Tool\n"
@@ -175,31 +314,32 @@ void Menu::MainMenu() {
 
 
 void Menu::DefaultMenu() {
-    string mode;
+    TransportMode mode;
     int source, destination;
-    vector<int> res;
-    vector<int> res2;
+    Path res;
+    Path res2;
     vector<pair<int,int>> avoid_edges;
 
     mode = getTransportationMode();
     source = getIntValue("Enter Source: ", true);
     destination = getIntValue("Enter Destination: ", true);
 
-    res = dijkstra.bestPath(&graph, source, destination, mode);
+    res = unrestrictedPath(workspace, source, destination, mode);
 
     displayInformationDriving(source, destination, res, avoid_edges, false, "BestDrivingRoute:");
 
-    res2 = dijkstra.bestPath(&graph, source, destination, mode, true, {}, avoid_edges);
+    vector<Path> routes = dijkstra.kShortestPaths(&network, workspace, res, mode, 2, alternatives);
+    res2 = routes.size() > 1 ? routes[1] : Path{{}, INF};
 
     displayInformationDriving(source, destination, res2, avoid_edges, true, "AlternativeDrivingRoute:");
 }
 
 
 void Menu::RestrictedMenu() {
-    string mode;
+    TransportMode mode;
     int source, destination;
-    vector<int> res;
-    vector<int> res2;
+    Path res;
+    Path res2;
 
     string restrictedStr;
     bool restricted;
@@ -215,19 +355,19 @@ void Menu::RestrictedMenu() {
     includeNode = getIncludeNode();
 
     if (includeNode == -1) {
-        res = dijkstra.bestPath(&graph, source, destination, mode, false, avoid_nodes, avoid_edges);
+        res = routePath(workspace, source, destination, mode, avoid_nodes, avoid_edges);
         displayInformationDriving(source, destination, res, avoid_edges, false, "RestrictedDrivingRoute:");
     }
     else {
         cout << "RestrictedDrivingRoute:";
-        res = dijkstra.bestPath(&graph, source, includeNode, mode, false, avoid_nodes, avoid_edges);
-        double includeDist = graph.findVertex(includeNode)->getDist();
+        res = routePath(workspace, source, includeNode, mode, avoid_nodes, avoid_edges);
+        double includeDist = res.weight;
         if (includeDist != INF) {
-            res2 = dijkstra.bestPath(&graph, includeNode, destination, mode, true, avoid_nodes, avoid_edges);
-            if (graph.findVertex(destination)->getDist() != INF) {
-                for (int i = 0; i < res.size(); i++) cout << res[i] << ",";
-                for (int i = 1; i < res2.size(); i++) cout << res2[i] << (i == res2.size() - 1 ? "" : ",");
-                cout << "(" << includeDist + graph.findVertex(destination)->getDist() << ")" << endl;
+            res2 = routePath(workspace, includeNode, destination, mode, alternativeAvoidNodes(avoid_nodes, res), avoid_edges);
+            if (res2.weight != INF) {
+                for (int i = 0; i < res.path.size(); i++) cout << res.path[i] << ",";
+                for (int i = 1; i < res2.path.size(); i++) cout << res2.path[i] << (i == res2.path.size() - 1 ? "" : ",");
+                cout << "(" << includeDist + res2.weight << ")" << endl;
             } else cout << "none" << endl;
         }
         else cout << "none" << endl;
@@ -246,16 +386,16 @@ void Menu::MenuDrivingWalking() {
     maxWalking = getIntValue("Enter Max Walking Time: ", false);
     getRestrictedParameters(avoid_nodes, avoid_edges);
 
-    auto [res, res2] = dijkstra.bestPathDriveWalk(&graph, source, destination, maxWalking, message, false, avoid_nodes, avoid_edges);
+    auto [res, res2] = driveWalkPath(workspace, source, destination, maxWalking, message, avoid_nodes, avoid_edges);
 
-    cout << "Source:" << graph.findVertex(source)->getID() << endl;
-    cout << "Destination:" << graph.findVertex(destination)->getID() << endl;
+    cout << "Source:" << source << endl;
+    cout << "Destination:" << destination << endl;
     if (message.empty()) {
         cout << "DrivingRoute:";
         for (int i = 0; i < res.first.path.size(); i++) {
             cout << res.first.path[i] << (i == res.first.path.size() - 1 ? "" : ",");
         } cout << "(" << res.first.weight << ")" << endl;
-        cout << "ParkingNode:" << res.second.path[0] << endl;
+        cout << "ParkingNode:" << (res.second.path.empty() ? "none" : to_string(res.second.path[0])) << endl;
         cout << "WalkingRoute:";
         for (int i = 0; i < res.second.path.size(); i++) {
             cout << res.second.path[i] << (i == res.second.path.size() - 1 ? "" : ",");
@@ -270,7 +410,7 @@ void Menu::MenuDrivingWalking() {
         for (int i = 0; i < res.first.path.size(); i++) {
             cout << res.first.path[i] << (i == res.first.path.size() - 1 ? "" : ",");
         } cout << "(" << res.first.weight << ")" << endl;
-        cout << "ParkingNode1:" << res.second.path[0] << endl;
+        cout << "ParkingNode1:" << (res.second.path.empty() ? "none" : to_string(res.second.path[0])) << endl;
         cout << "WalkingRoute1:";
         for (int i = 0; i < res.second.path.size(); i++) {
             cout << res.second.path[i] << (i == res.second.path.size() - 1 ? "" : ",");
@@ -281,7 +421,7 @@ void Menu::MenuDrivingWalking() {
         for (int i = 0; i < res2.first.path.size(); i++) {
             cout << res2.first.path[i] << (i == res2.first.path.size() - 1 ? "" : ",");
         } cout << "(" << res2.first.weight << ")" << endl;
-        cout << "ParkingNode2:" << res2.second.path[0] << endl;
+        cout << "ParkingNode2:" << (res2.second.path.empty() ? "none" : to_string(res2.second.path[0])) << endl;
         cout << "WalkingRoute2:";
         for (int i = 0; i < res2.second.path.size(); i++) {
             cout << res2.second.path[i] << (i == res2.second.path.size() - 1 ? "" : ",");
@@ -291,82 +431,195 @@ void Menu::MenuDrivingWalking() {
 }
 
 
-void Menu::MenuBatchMode(const string& inFile, const string& outFile) {
+void Menu::MenuBatchMode(const string& inFile, const string& outFile, unsigned threads) {
+    vector<RouteRequest> requests;
+    DataReader reader = DataReader();
+    reader.readInputFile(inFile, requests);
+
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+    threads = min<unsigned>(threads, max<size_t>(requests.size(), 1));
+
+    auto startTime = chrono::steady_clock::now();
+
+    // each worker takes the next request and writes its answer to its own slot, so the output keeps the input order
+    vector<string> results(requests.size());
+    atomic<size_t> next = 0;
+#ifdef ROUTING_INSTRUMENTATION
+    StatsHistogram histogram; // of the requests not answered by the cache
+    mutex histogramMutex;
+#endif
+    auto worker = [&]() {
+        SearchWorkspace ws;
+        ws.walkingTables = workspace.walkingTables;
+#ifdef ROUTING_INSTRUMENTATION
+        StatsHistogram local;
+#endif
+        for (size_t i = next++; i < requests.size(); i = next++) {
+            const string key = RouteCache::makeKey(requests[i]);
+            if (answers.find(key, results[i])) continue;
+            ostringstream out;
+#ifdef ROUTING_INSTRUMENTATION
+            QueryStats stats;
+            {
+                StatsScope scope(stats);
+                processBatchRequest(requests[i], ws, out);
+            }
+            local.add(stats);
+#else
+            processBatchRequest(requests[i], ws, out);
+#endif
+            results[i] = out.str();
+            answers.insert(key, results[i]);
+        }
+#ifdef ROUTING_INSTRUMENTATION
+        lock_guard lock(histogramMutex);
+        histogram.merge(local);
+#endif
+    };
+    vector<thread> pool;
+    for (unsigned i = 1; i < threads; i++) pool.emplace_back(worker);
+    worker();
+    for (auto &t : pool) t.join();
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+
     ofstream out(outFile);
+    for (size_t i = 0; i < results.size(); i++) {
+        if (i > 0) out << '\n';
+        out << results[i];
+    }
+    out.close();
 
-    string mode;
-    int source, destination;
-    int includeNode = -1;
-    vector<int> avoidNodes;
-    vector<pair<int,int>> avoid_edges;
-    string message;
-    int maxWalking;
+    cout << "Processed " << requests.size() << " queries in " << seconds << " s using " << threads << " threads ("
+         << (seconds > 0 ? requests.size() / seconds : 0) << " queries/sec)" << endl;
+    auto cached = answers.getStats();
+    cout << "Answer cache: " << cached.hits << " hits, " << cached.misses << " misses ("
+         << (cached.hits + cached.misses > 0 ? 100.0 * cached.hits / (cached.hits + cached.misses) : 0) << "% hit rate), "
+         << cached.entries << " answers, " << cached.bytes / 1024 << " KiB of " << cached.capacity / 1024 << " KiB, "
+         << cached.evictions << " evictions" << endl;
+    auto stats = walkingTables.getStats();
+    if (stats.hits + stats.misses > 0) {
+        cout << "Walking table cache: " << stats.hits << " hits, " << stats.misses << " misses ("
+             << 100.0 * stats.hits / (stats.hits + stats.misses) << "% hit rate), " << stats.entries << " tables, "
+             << stats.bytes / 1024 << " KiB of " << stats.capacity / 1024 << " KiB, " << stats.evictions << " evictions" << endl;
+    }
+#ifdef ROUTING_INSTRUMENTATION
+    histogram.print(cout, "Query stats");
+#endif
+}
 
-    DataReader reader = DataReader();
-    reader.readInputFile(inFile, mode, source, destination, avoidNodes, avoid_edges, includeNode, maxWalking);
 
-    out << "Source:" << graph.findVertex(source)->getID() << '\n';
-    out << "Destination:" << graph.findVertex(destination)->getID() << '\n';
-    if (mode != "driving-walking") {
-        vector<int> res;
-        vector<int> res2;
+bool Menu::MenuMatrixMode(const string& inFile, const string& outFile, unsigned threads) {
+    MatrixRequest request;
+    string error;
+    if (!reader.readMatrixRequest(inFile, request, error)) {
+        cerr << error << endl;
+        return false;
+    }
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+
+    auto startTime = chrono::steady_clock::now();
+    vector<double> matrix = dijkstra.manyToMany(&network, request.sources, request.targets, request.mode, threads);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+
+    ofstream out(outFile);
+    if (!out) {
+        cerr << "Error opening file " << outFile << endl;
+        return false;
+    }
+    out << "Source";
+    for (int target : request.targets) out << ',' << target;
+    out << '\n';
+    for (size_t i = 0; i < request.sources.size(); i++) {
+        out << request.sources[i];
+        for (size_t j = 0; j < request.targets.size(); j++) {
+            double dist = matrix[i * request.targets.size() + j];
+            out << ',';
+            if (dist == INF) out << 'X';
+            else out << dist;
+        }
+        out << '\n';
+    }
+    out.close();
+
+    cout << "Computed " << request.sources.size() << "x" << request.targets.size() << " " << toString(request.mode)
+         << " matrix in " << seconds << " s using " << min<size_t>(threads, request.sources.size()) << " threads" << endl;
+    return true;
+}
+
+
+void Menu::processBatchRequest(const RouteRequest &request, SearchWorkspace &ws, std::ostream &out) const {
+    const TransportMode mode = request.mode;
+    const int source = request.source, destination = request.destination;
+    const int includeNode = request.includeNode;
+    const vector<int> &avoidNodes = request.avoidNodes;
+    vector<pair<int,int>> avoid_edges = request.avoidSegments;
+    string message;
+    const int maxWalking = request.maxWalking;
+
+    out << "Source:" << source << '\n';
+    out << "Destination:" << destination << '\n';
+    if (mode != TransportMode::DRIVING_WALKING) {
+        Path res;
+        Path res2;
         if (includeNode == -1 && avoidNodes.empty() && avoid_edges.empty()) {
             out << "BestDrivingRoute:";
 
-            res = dijkstra.bestPath(&graph, source, destination, mode, false, avoidNodes, avoid_edges);
+            res = unrestrictedPath(ws, source, destination, mode);
 
-            for (int i = 0; i < res.size(); i++) {
-                if (i + 1 < res.size()) {
-                    avoid_edges.emplace_back(res[i], res[i+1]);
+            for (int i = 0; i < res.path.size(); i++) {
+                if (i + 1 < res.path.size()) {
+                    avoid_edges.emplace_back(res.path[i], res.path[i+1]);
                 }
-                out << res[i] << (i == res.size() - 1 ? "" : ",");
+                out << res.path[i] << (i == res.path.size() - 1 ? "" : ",");
             }
-            out << "(" << graph.findVertex(destination)->getDist() << ")" << endl;
+            out << "(" << res.weight << ")" << endl;
 
-            res2 = dijkstra.bestPath(&graph, source, destination, mode, true, {}, avoid_edges);
+            vector<Path> routes = dijkstra.kShortestPaths(&network, ws, res, mode, 2, alternatives);
+            res2 = routes.size() > 1 ? routes[1] : Path{{}, INF};
 
             out << "AlternativeDrivingRoute:";
-            if (graph.findVertex(destination)->getDist() == INF) {
+            if (res2.weight == INF) {
                 out << "none" << endl;
             }
             else {
-                for (int i = 0; i < res2.size(); i++) out << res2[i] << (i == res2.size() - 1 ? "" : ",");
-                out << "(" << graph.findVertex(destination)->getDist() << ")" << endl;
+                for (int i = 0; i < res2.path.size(); i++) out << res2.path[i] << (i == res2.path.size() - 1 ? "" : ",");
+                out << "(" << res2.weight << ")" << endl;
             }
         }
         else {
             out << "RestrictedDrivingRoute:";
 
             if (includeNode == -1) {
-                res = dijkstra.bestPath(&graph, source, destination, mode, false, avoidNodes, avoid_edges);
+                res = routePath(ws, source, destination, mode, avoidNodes, avoid_edges);
 
-                if (graph.findVertex(destination)->getDist() == INF) {
+                if (res.weight == INF) {
                     out << "none" << '\n';
                 } else {
-                    for (int i = 0; i < res.size(); i++) {
-                        if (i + 1 < res.size()) {
-                            avoid_edges.emplace_back(res[i], res[i+1]);
+                    for (int i = 0; i < res.path.size(); i++) {
+                        if (i + 1 < res.path.size()) {
+                            avoid_edges.emplace_back(res.path[i], res.path[i+1]);
                         }
-                        out << res[i] << (i == res.size() - 1 ? "" : ",");
+                        out << res.path[i] << (i == res.path.size() - 1 ? "" : ",");
                     }
-                    out << "(" << graph.findVertex(destination)->getDist() << ")" << '\n';
+                    out << "(" << res.weight << ")" << '\n';
                 }
             }
             else {
-                res = dijkstra.bestPath(&graph, source, includeNode, mode, false, avoidNodes, avoid_edges);
-                double includeDist = graph.findVertex(includeNode)->getDist();
+                res = routePath(ws, source, includeNode, mode, avoidNodes, avoid_edges);
+                double includeDist = res.weight;
                 if (includeDist != INF) {
-                    res2 = dijkstra.bestPath(&graph, includeNode, destination, mode, true, avoidNodes, avoid_edges);
+                    res2 = routePath(ws, includeNode, destination, mode, alternativeAvoidNodes(avoidNodes, res), avoid_edges);
 
-                    if (graph.findVertex(destination)->getDist() != INF) {
+                    if (res2.weight != INF) {
 
-                        for (int i = 0; i < res.size(); i++) {
-                            out << res[i] << ",";
+                        for (int i = 0; i < res.path.size(); i++) {
+                            out << res.path[i] << ",";
                         }
-                        for (int i = 1; i < res2.size(); i++) {
-                            out << res2[i] << (i == res2.size() - 1 ? "" : ",");
+                        for (int i = 1; i < res2.path.size(); i++) {
+                            out << res2.path[i] << (i == res2.path.size() - 1 ? "" : ",");
                         }
-                        out << "(" << includeDist + graph.findVertex(destination)->getDist() << ")" << '\n';
+                        out << "(" << includeDist + res2.weight << ")" << '\n';
 
                     } else out << "none" << '\n';
                 }
@@ -375,14 +628,14 @@ void Menu::MenuBatchMode(const string& inFile, const string& outFile) {
         }
     }
     else {
-        auto [res, res2] = dijkstra.bestPathDriveWalk(&graph, source, destination, maxWalking, message, false, avoidNodes, avoid_edges);
+        auto [res, res2] = driveWalkPath(ws, source, destination, maxWalking, message, avoidNodes, avoid_edges);
 
         if (message.empty()) {
             out << "DrivingRoute:";
             for (int i = 0; i < res.first.path.size(); i++) {
                 out << res.first.path[i] << (i == res.first.path.size() - 1 ? "" : ",");
             } out << "(" << res.first.weight << ")" << '\n';
-            out << "ParkingNode:" << res.second.path[0] << '\n';
+            out << "ParkingNode:" << (res.second.path.empty() ? "none" : to_string(res.second.path[0])) << '\n';
             out << "WalkingRoute:";
             for (int i = 0; i < res.second.path.size(); i++) {
                 out << res.second.path[i] << (i == res.second.path.size() - 1 ? "" : ",");
@@ -397,7 +650,7 @@ void Menu::MenuBatchMode(const string& inFile, const string& outFile) {
             for (int i = 0; i < res.first.path.size(); i++) {
                 out << res.first.path[i] << (i == res.first.path.size() - 1 ? "" : ",");
             } out << "(" << res.first.weight << ")" << '\n';
-            out << "ParkingNode1:" << res.second.path[0] << '\n';
+            out << "ParkingNode1:" << (res.second.path.empty() ? "none" : to_string(res.second.path[0])) << '\n';
             out << "WalkingRoute1:";
             for (int i = 0; i < res.second.path.size(); i++) {
                 out << res.second.path[i] << (i == res.second.path.size() - 1 ? "" : ",");
@@ -408,7 +661,7 @@ void Menu::MenuBatchMode(const string& inFile, const string& outFile) {
             for (int i = 0; i < res2.first.path.size(); i++) {
                 out << res2.first.path[i] << (i == res2.first.path.size() - 1 ? "" : ",");
             } out << "(" << res2.first.weight << ")" << '\n';
-            out << "ParkingNode2:" << res2.second.path[0] << '\n';
+            out << "ParkingNode2:" << (res2.second.path.empty() ? "none" : to_string(res2.second.path[0])) << '\n';
             out << "WalkingRoute2:";
             for (int i = 0; i < res2.second.path.size(); i++) {
                 out << res2.second.path[i] << (i == res2.second.path.size() - 1 ? "" : ",");
@@ -416,7 +669,6 @@ void Menu::MenuBatchMode(const string& inFile, const string& outFile) {
             out << "TotalTime2:" << res2.first.weight + res2.second.weight << '\n';
         }
     }
-    out.close();
 }
 
 
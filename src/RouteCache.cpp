@@ -0,0 +1,100 @@
+#include "../headers/RouteCache.h"
+
+#include <algorithm>
+
+using namespace std;
+
+// approximate memory of the list and hash table nodes of an entry
+static constexpr size_t ENTRY_OVERHEAD = 4 * sizeof(void *) + sizeof(string_view) + sizeof(list<int>::iterator);
+
+
+RouteCache::RouteCache(const size_t capacity, const unsigned shards) : shardCapacity(capacity / max(1u, shards)) {
+    for (unsigned i = 0; i < max(1u, shards); i++) {
+        this->shards.push_back(make_unique<Shard>());
+        this->shards.back()->stats.capacity = shardCapacity;
+    }
+}
+
+
+string RouteCache::makeKey(const RouteRequest &request) {
+    vector<int> nodes = request.avoidNodes;
+    vector<pair<int, int>> segments = request.avoidSegments;
+    sort(nodes.begin(), nodes.end());
+    nodes.erase(unique(nodes.begin(), nodes.end()), nodes.end());
+    sort(segments.begin(), segments.end());
+    segments.erase(unique(segments.begin(), segments.end()), segments.end());
+
+    // the include node only applies to driving-only requests and the walking limit to driving-walking ones
+    const bool driveWalk = request.mode == TransportMode::DRIVING_WALKING;
+    const int fields[] = {static_cast<int>(request.mode), request.source, request.destination,
+                          driveWalk ? -1 : request.includeNode, driveWalk ? request.maxWalking : 0, (int) nodes.size()};
+    string key;
+    key.reserve(sizeof(fields) + nodes.size() * sizeof(int) + segments.size() * sizeof(pair<int, int>));
+    key.append(reinterpret_cast<const char *>(fields), sizeof(fields));
+    key.append(reinterpret_cast<const char *>(nodes.data()), nodes.size() * sizeof(int));
+    for (auto &s : segments) {
+        key.append(reinterpret_cast<const char *>(&s.first), sizeof(int));
+        key.append(reinterpret_cast<const char *>(&s.second), sizeof(int));
+    }
+    return key;
+}
+
+
+bool RouteCache::find(const string &key, string &answer) {
+    Shard &shard = shardOf(key);
+    lock_guard lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it == shard.index.end()) {
+        shard.stats.misses++;
+        return false;
+    }
+    shard.stats.hits++;
+    shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+    answer = it->second->answer;
+    return true;
+}
+
+
+void RouteCache::insert(const string &key, const string &answer) {
+    const size_t bytes = sizeof(Entry) + ENTRY_OVERHEAD + key.size() + answer.size();
+    Shard &shard = shardOf(key);
+    lock_guard lock(shard.mutex);
+    if (bytes > shardCapacity || shard.index.count(key) > 0) return;
+
+    while (shard.stats.bytes + bytes > shardCapacity) {
+        shard.stats.bytes -= shard.entries.back().bytes;
+        shard.index.erase(shard.entries.back().key);
+        shard.entries.pop_back();
+        shard.stats.evictions++;
+    }
+    shard.entries.push_front({key, answer, bytes});
+    shard.index.emplace(shard.entries.front().key, shard.entries.begin());
+    shard.stats.entries = shard.entries.size();
+    shard.stats.bytes += bytes;
+}
+
+
+void RouteCache::clear() {
+    for (auto &shard : shards) {
+        lock_guard lock(shard->mutex);
+        shard->index.clear();
+        shard->entries.clear();
+        shard->stats.entries = 0;
+        shard->stats.bytes = 0;
+    }
+}
+
+
+RouteCache::Stats RouteCache::getStats() const {
+    Stats res;
+    for (auto &shard : shards) {
+        lock_guard lock(shard->mutex);
+        res.hits += shard->stats.hits;
+        res.misses += shard->stats.misses;
+        res.evictions += shard->stats.evictions;
+        res.entries += shard->stats.entries;
+        res.bytes += shard->stats.bytes;
+        res.capacity += shard->stats.capacity;
+    }
+    return res;
+}
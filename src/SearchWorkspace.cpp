@@ -0,0 +1,59 @@
+#include "../headers/SearchWorkspace.h"
+
+#include <algorithm>
+
+using namespace std;
+
+
+void SearchTree::reset(const int numVertex) {
+    settled = 0;
+    if ((int) nodes.size() != numVertex) {
+        nodes.assign(numVertex, SearchNode());
+        touched.clear();
+        return;
+    }
+    for (int v : touched) nodes[v] = SearchNode();
+    touched.clear();
+}
+
+
+void SearchTree::set(const int v, const double dist, const int parent) {
+    if (nodes[v].dist == INF) touched.push_back(v);
+    nodes[v].dist = dist;
+    nodes[v].key = dist;
+    nodes[v].parent = parent;
+}
+
+
+void SearchWorkspace::setAvoided(const CsrGraph *g, const vector<int> &avoid_nodes, const vector<pair<int,int>> &avoid_edges) {
+    size_t words = (g->getNumVertex() + 63) / 64;
+    if (avoidNode.size() != words) {
+        avoidNode.assign(words, 0);
+        avoidOut.assign(words, 0);
+    }
+    else {
+        for (int v : avoidedNodes) avoidNode[v >> 6] = 0;
+        for (auto &e : avoidedEdges) avoidOut[e.first >> 6] = 0;
+    }
+    avoidedNodes.clear();
+    avoidedEdges.clear();
+
+    for (auto node : avoid_nodes) {
+        int v = g->findVertexIdx(node);
+        if (v == -1) continue;
+        avoidNode[v >> 6] |= 1ULL << (v & 63);
+        avoidedNodes.push_back(v);
+    }
+    for (auto edge : avoid_edges) {
+        int u = g->findVertexIdx(edge.first), v = g->findVertexIdx(edge.second);
+        if (u == -1 || v == -1) continue;
+        avoidOut[u >> 6] |= 1ULL << (u & 63);
+        avoidedEdges.emplace_back(u, v);
+    }
+}
+
+
+bool SearchWorkspace::isAvoided(const int u, const int v) const {
+    if (!(avoidOut[u >> 6] >> (u & 63) & 1)) return false;
+    return find(avoidedEdges.begin(), avoidedEdges.end(), make_pair(u, v)) != avoidedEdges.end();
+}
@@ -0,0 +1,115 @@
+#include "../headers/WalkingTableCache.h"
+
+#include <algorithm>
+
+using namespace std;
+
+
+WalkingTable::WalkingTable(const CsrGraph *g, const SearchTree &tree) {
+    const int n = g->getNumVertex();
+    for (int v = 0; v < n; v++) {
+        if (!g->getParking(v) || tree.getDist(v) == INF) continue;
+        parking.push_back(v);
+        dist.push_back(tree.getDist(v));
+    }
+}
+
+
+size_t WalkingTable::bytes() const {
+    return sizeof(*this) + parking.capacity() * sizeof(int) + dist.capacity() * sizeof(double);
+}
+
+
+WalkingTableCache::WalkingTableCache(const size_t capacity) : capacity(capacity) {
+    stats.capacity = capacity;
+}
+
+
+WalkingTableCache::Key WalkingTableCache::makeKey(const CsrGraph *g, const int destination, const vector<int> &avoid_nodes, const vector<pair<int,int>> &avoid_edges) {
+    Key key = {destination, {}, {}, 0};
+    for (int node : avoid_nodes) {
+        int v = g->findVertexIdx(node);
+        if (v != -1) key.nodes.push_back(v);
+    }
+    for (auto &edge : avoid_edges) {
+        int u = g->findVertexIdx(edge.first), v = g->findVertexIdx(edge.second);
+        if (u != -1 && v != -1) key.edges.emplace_back(u, v);
+    }
+    sort(key.nodes.begin(), key.nodes.end());
+    key.nodes.erase(unique(key.nodes.begin(), key.nodes.end()), key.nodes.end());
+    sort(key.edges.begin(), key.edges.end());
+    key.edges.erase(unique(key.edges.begin(), key.edges.end()), key.edges.end());
+
+    // FNV-1a over the destination and the sorted indexes
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](uint64_t x) { hash = (hash ^ x) * 1099511628211ULL; };
+    mix(destination);
+    for (int v : key.nodes) mix(v);
+    mix(~0ULL);
+    for (auto &e : key.edges) mix((uint64_t) e.first << 32 | (uint32_t) e.second);
+    key.hash = hash;
+    return key;
+}
+
+
+void WalkingTableCache::checkGraph(const CsrGraph *g) {
+    if (g == graph && g->getNumVertex() == numVertex) return;
+    removeAll();
+    graph = g;
+    numVertex = g->getNumVertex();
+}
+
+
+void WalkingTableCache::removeAll() {
+    entries.clear();
+    index.clear();
+    stats.entries = 0;
+    stats.bytes = 0;
+}
+
+
+shared_ptr<const WalkingTable> WalkingTableCache::find(const CsrGraph *g, const int destination, const vector<int> &avoid_nodes, const vector<pair<int,int>> &avoid_edges) {
+    Key key = makeKey(g, destination, avoid_nodes, avoid_edges);
+    lock_guard lock(mutex);
+    checkGraph(g);
+    auto it = index.find(key);
+    if (it == index.end()) {
+        stats.misses++;
+        return nullptr;
+    }
+    stats.hits++;
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->table;
+}
+
+
+void WalkingTableCache::insert(const CsrGraph *g, const int destination, const vector<int> &avoid_nodes, const vector<pair<int,int>> &avoid_edges, shared_ptr<const WalkingTable> table) {
+    Key key = makeKey(g, destination, avoid_nodes, avoid_edges);
+    size_t bytes = sizeof(Entry) + table->bytes() + key.nodes.capacity() * sizeof(int) + key.edges.capacity() * sizeof(pair<int, int>);
+    lock_guard lock(mutex);
+    checkGraph(g);
+    if (bytes > capacity || index.count(key) > 0) return;
+
+    while (stats.bytes + bytes > capacity) {
+        stats.bytes -= entries.back().bytes;
+        index.erase(entries.back().key);
+        entries.pop_back();
+        stats.evictions++;
+    }
+    entries.push_front({key, std::move(table), bytes});
+    index.emplace(std::move(key), entries.begin());
+    stats.entries = entries.size();
+    stats.bytes += bytes;
+}
+
+
+void WalkingTableCache::clear() {
+    lock_guard lock(mutex);
+    removeAll();
+}
+
+
+WalkingTableCache::Stats WalkingTableCache::getStats() const {
+    lock_guard lock(mutex);
+    return stats;
+}
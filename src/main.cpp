@@ -1,24 +1,120 @@
 #include <iostream>
 #include <string>
+#include <vector>
 #include "../headers/graph.h"
 #include "../headers/Menu.h"
 
+/*
+ * Parses a non-negative count given on the command line.
+ */
+static bool parseCount(const std::string &text, unsigned &value) {
+    if (text.empty() || text.size() > 9 || text.find_first_not_of("0123456789") != std::string::npos) return false;
+    value = std::stoul(text);
+    return true;
+}
+
+/*
+ * Prints the command-line usage and returns the exit status of invalid arguments.
+ */
+static int usage(const char *program) {
+    std::cerr << "Usage: " << program << " [--snapshot <file>] [--all-pairs [max-vertices]]"
+              << " [--engine dijkstra|bidirectional|astar] [--ch <prefix>] [--layered-drive-walk] [--walking-cache]"
+              << " [--alternatives node-disjoint|loopless]"
+              << " [<input> <output> [threads] | --matrix <input> <output> [threads]]" << std::endl
+              << "       " << program << " --save-snapshot <file>" << std::endl;
+    return 1;
+}
+
 /**
  * Entry point of the application.
+ * Usage:
+ * - `project1` for the interactive menu, or `project1 <input> <output> [threads]` for batch mode;
+ * - `project1 --snapshot <file> ...` to do the same with a binary graph snapshot instead of the docs CSV files;
+ * - `project1 --save-snapshot <file>` to read the CSV files once and write the snapshot;
+ * - `project1 [--snapshot <file>] --matrix <input> <output> [threads]` to write a distance matrix (see Menu::MenuMatrixMode);
+ * - `--all-pairs [max-vertices]` after the graph options, in any of the above, precomputes the all-pairs tables
+ *   (see Menu::buildAllPairs) and goes on without them if the graph is too large;
+ * - `--engine <name>` after the graph options selects the search engine of the routes (see Menu::setRouteEngine);
+ * - `--ch <prefix>` after the graph options loads the contraction hierarchies written by ch_preprocess
+ *   (see Menu::loadHierarchies), which then answer the unrestricted routes;
+ * - `--layered-drive-walk` after the graph options finds the driving-walking routes with DriveWalkSearch
+ *   (see Menu::setLayeredDriveWalk);
+ * - `--walking-cache` after the graph options caches the walking searches of the driving-walking routes
+ *   (see Menu::setWalkingCache);
+ * - `--alternatives loopless` after the graph options makes the alternative route the second best one instead of
+ *   one sharing no node with the best route (see Menu::setAlternatives).
+ * Paths are relative to the project directory. Other arguments, or a thread count that is not a number, print the usage.
  * @param argc Number of command-line arguments.
  * @param argv Array of command-line arguments.
  * @return Exit status of the program.
  */
 int main(int argc , char *argv[]) {
     Menu menu;
-    if (argc == 3) {
-        menu.readGraph();
-        const std::string inFile = argv[1];
-        const std::string outFile = argv[2];
-        menu.MenuBatchMode("../" + inFile, "../" + outFile);
+    std::vector<std::string> args(argv + 1, argv + argc);
+
+    if (args.size() == 2 && args[0] == "--save-snapshot") {
+        return menu.readGraph() && menu.saveSnapshot("../" + args[1]) ? 0 : 1;
     }
-    else {
+    if (args.size() >= 2 && args[0] == "--snapshot") {
+        if (!menu.loadSnapshot("../" + args[1])) return 1;
+        args.erase(args.begin(), args.begin() + 2);
+    }
+    else if (!menu.readGraph()) {
+        return 1;
+    }
+    while (!args.empty()) {
+        if (args[0] == "--all-pairs") {
+            args.erase(args.begin());
+            unsigned maxVertices = AllPairs::DEFAULT_MAX_VERTICES;
+            if (!args.empty() && !args[0].empty() && args[0].find_first_not_of("0123456789") == std::string::npos) {
+                if (!parseCount(args[0], maxVertices)) return usage(argv[0]);
+                args.erase(args.begin());
+            }
+            menu.buildAllPairs(maxVertices);
+        }
+        else if (args[0] == "--engine") {
+            RouteEngine engine;
+            if (args.size() < 2 || !parseRouteEngine(args[1], engine)) return usage(argv[0]);
+            menu.setRouteEngine(engine);
+            args.erase(args.begin(), args.begin() + 2);
+        }
+        else if (args[0] == "--alternatives") {
+            if (args.size() < 2 || (args[1] != "loopless" && args[1] != "node-disjoint")) return usage(argv[0]);
+            menu.setAlternatives(args[1] == "loopless" ? Disjointness::LOOPLESS : Disjointness::NODE_DISJOINT);
+            args.erase(args.begin(), args.begin() + 2);
+        }
+        else if (args[0] == "--walking-cache") {
+            menu.setWalkingCache(true);
+            args.erase(args.begin());
+        }
+        else if (args[0] == "--layered-drive-walk") {
+            menu.setLayeredDriveWalk(true);
+            args.erase(args.begin());
+        }
+        else if (args[0] == "--ch") {
+            if (args.size() < 2) return usage(argv[0]);
+            if (!menu.loadHierarchies("../" + args[1])) return 1;
+            args.erase(args.begin(), args.begin() + 2);
+        }
+        else break;
+    }
+
+    unsigned threads = 0;
+    if ((args.size() == 3 || args.size() == 4) && args[0] == "--matrix") {
+        if (args.size() == 4 && !parseCount(args[3], threads)) return usage(argv[0]);
+        return menu.MenuMatrixMode("../" + args[1], "../" + args[2], threads) ? 0 : 1;
+    }
+    if (args.size() == 2 || args.size() == 3) {
+        const std::string inFile = args[0];
+        const std::string outFile = args[1];
+        if (args.size() == 3 && !parseCount(args[2], threads)) return usage(argv[0]);
+        menu.MenuBatchMode("../" + inFile, "../" + outFile, threads);
+    }
+    else if (args.empty()) {
         menu.MainMenu();
     }
+    else {
+        return usage(argv[0]);
+    }
     return 0;
 }
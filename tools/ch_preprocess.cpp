@@ -0,0 +1,44 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include "../headers/ContractionHierarchy.h"
+#include "../headers/DataReader.h"
+
+/**
+ * Offline preprocessing of the contraction hierarchies of a map.
+ * Usage: `ch_preprocess <locations.csv> <distances.csv> <output prefix>`, which writes
+ * `<output prefix>.driving.ch` and `<output prefix>.walking.ch`, to be read with ContractionHierarchy::load.
+ * @param argc Number of command-line arguments.
+ * @param argv Array of command-line arguments.
+ * @return Exit status of the program.
+ */
+int main(int argc, char *argv[]) {
+    if (argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <locations.csv> <distances.csv> <output prefix>" << std::endl;
+        return 1;
+    }
+    Graph<int> graph;
+    DataReader reader;
+    std::string error;
+    if (!reader.loadLocations(argv[1], graph, error) || !reader.loadDistances(argv[2], graph, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    CsrGraph network(graph);
+
+    const std::pair<TransportMode, std::string> modes[] = {{TransportMode::DRIVING, "driving"}, {TransportMode::WALKING, "walking"}};
+    for (auto &[mode, name] : modes) {
+        auto begin = std::chrono::steady_clock::now();
+        ContractionHierarchy ch(&network, CsrGraph::modeIndex(mode));
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        const std::string fileName = std::string(argv[3]) + "." + name + ".ch";
+        if (!ch.save(fileName)) {
+            std::cerr << "Error writing file " << fileName << std::endl;
+            return 1;
+        }
+        std::cout << name << ": " << network.getNumEdges(CsrGraph::modeIndex(mode)) << " edges, "
+                  << ch.getNumShortcuts() << " shortcuts, contracted in " << seconds << " s -> " << fileName << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include "../headers/MapGenerator.h"
+
+/**
+ * Generator of synthetic maps for scale testing, writing Locations and Distances files that DataReader reads.
+ * Usage: `mapgen <locations.csv> <distances.csv> [options]`, with the options (defaults in MapOptions):
+ * - `--vertices n`: number of locations;
+ * - `--topology grid|geometric`: square grid or random geometric graph;
+ * - `--degree d`: average number of segments per location (geometric);
+ * - `--degree-shape poisson|power-law` and `--degree-exponent e`: distribution of the degrees (geometric);
+ * - `--parking p`: probability of a location having parking;
+ * - `--no-driving p` and `--no-walking p`: probability of a segment having X as driving or walking time;
+ * - `--driving-speed min max` and `--walking-speed s`: speeds in km/h, which set the travel times;
+ * - `--seed n`: the same seed and options always produce the same files.
+ * @param argc Number of command-line arguments.
+ * @param argv Array of command-line arguments.
+ * @return Exit status of the program.
+ */
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <locations.csv> <distances.csv> [--vertices n] [--topology grid|geometric]"
+                  << " [--degree d] [--degree-shape poisson|power-law] [--degree-exponent e] [--parking p]"
+                  << " [--no-driving p] [--no-walking p] [--driving-speed min max] [--walking-speed s] [--seed n]" << std::endl;
+        return 1;
+    }
+    MapOptions options;
+    try {
+        for (int i = 3; i < argc; i++) {
+            const std::string option = argv[i];
+            const int values = option == "--driving-speed" ? 2 : 1;
+            if (i + values >= argc) {
+                std::cerr << "Missing value of option " << option << std::endl;
+                return 1;
+            }
+            const std::string value = argv[i + 1];
+            if (option == "--vertices") options.vertices = std::stoul(value);
+            else if (option == "--topology" && (value == "grid" || value == "geometric")) {
+                options.topology = value == "grid" ? MapTopology::GRID : MapTopology::GEOMETRIC;
+            }
+            else if (option == "--degree") options.averageDegree = std::stod(value);
+            else if (option == "--degree-shape" && (value == "poisson" || value == "power-law")) {
+                options.degreeShape = value == "poisson" ? DegreeShape::POISSON : DegreeShape::POWER_LAW;
+            }
+            else if (option == "--degree-exponent") options.degreeExponent = std::stod(value);
+            else if (option == "--parking") options.parkingDensity = std::stod(value);
+            else if (option == "--no-driving") options.noDriving = std::stod(value);
+            else if (option == "--no-walking") options.noWalking = std::stod(value);
+            else if (option == "--driving-speed") {
+                options.minDrivingSpeed = std::stod(value);
+                options.maxDrivingSpeed = std::stod(argv[i + 2]);
+            }
+            else if (option == "--walking-speed") options.walkingSpeed = std::stod(value);
+            else if (option == "--seed") options.seed = std::stoull(value);
+            else {
+                std::cerr << "Invalid option " << option << " " << value << std::endl;
+                return 1;
+            }
+            i += values;
+        }
+    } catch (const std::exception &) {
+        std::cerr << "Invalid number in the options" << std::endl;
+        return 1;
+    }
+
+    MapGenerator generator(options);
+    std::string error;
+    auto begin = std::chrono::steady_clock::now();
+    if (!generator.write(argv[1], argv[2], error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << options.vertices << " locations, " << generator.getNumSegments() << " segments, written in "
+              << seconds << " s -> " << argv[1] << ", " << argv[2] << std::endl;
+    return 0;
+}